@@ -0,0 +1,63 @@
+// allocations.cpp - replacement of the global operator new in debug and test builds,
+// counting allocations per thread for the allocation-free analysis check
+
+#include "allocations.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+static thread_local size_t allocations = 0;
+
+size_t threadAllocations() {
+	return allocations;
+}
+
+void* operator new(size_t size) {
+	allocations++;
+	if (void* memory = std::malloc(size ? size : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	allocations++;
+	const size_t align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+	void* memory = _aligned_malloc(size ? size : 1, align);
+#else
+	// aligned_alloc wants a multiple of the alignment
+	void* memory = std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+#endif
+	if (memory) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+#ifdef _MSC_VER
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept {
+	operator delete(memory, alignment);
+}
+
+#endif
@@ -0,0 +1,19 @@
+// allocations.h - count of heap allocations made by the calling thread, in debug builds
+// and wherever COUNT_ALLOCATIONS is defined
+
+#ifndef AUDIOANALYSER_ALLOCATIONS_H
+#define AUDIOANALYSER_ALLOCATIONS_H
+
+#include <cstddef>
+
+#if defined(_DEBUG) && !defined(COUNT_ALLOCATIONS)
+#define COUNT_ALLOCATIONS
+#endif
+
+#ifdef COUNT_ALLOCATIONS
+// number of times the calling thread went through operator new,
+// compare two readings to check a code path does not allocate
+size_t threadAllocations();
+#endif
+
+#endif
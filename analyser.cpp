@@ -0,0 +1,269 @@
+// analyser.cpp - hop scheduling, frame analysis and publication of bar levels
+
+#include "analyser.h"
+#include "settings.h"
+#include "allocations.h"
+#include "levels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+Analyser::Analyser(RingBuffer<sf::Int16>& samples, TripleBuffer<SpectrumFrame>& spectrum) : samples(samples), spectrum(spectrum), plan(windowSize), fresh(true), position(0), running(false), analysed(0), skipped(0), late(0), settled(0), allocating(0) {
+	settings.bars = bars;
+	settings.rate = captureRate;
+	settings.window = windowSize;
+	settings.hop = hopSize;
+	settings.maxFrequency = maxFrequency;
+	settings.spacing = spacing;
+	settings.decimation = decimation;
+	settings.windowType = windowType;
+	settings.peakDecay = peakDecay;
+	settings.peakHold = peakHold;
+	settings.scale1 = scale1;
+	settings.scale2 = scale2;
+	settings.smoothing = smoothing;
+	settings.delayedPeaks = delayedPeaks;
+	settings.decaySmoothing = decaySmoothing;
+	const size_t factor = decimationFactor();
+	decimator.configure(factor);
+	prepare(windowSize / factor, bars, settings.rate / (double)factor);
+}
+
+void Analyser::start() {
+	running = true;
+	thread = std::thread(&Analyser::run, this);
+}
+
+void Analyser::stop() {
+	running = false;
+	if (thread.joinable()) {
+		thread.join();
+	}
+	std::cout << "Frames Analysed: " << analysed << ", Skipped: " << skipped << ", Late: " << late << std::endl;
+	std::cout << "Frames Published: " << spectrum.publishedFrames() << ", Overwritten Before Display: " << spectrum.overwrittenFrames() << std::endl;
+#ifdef COUNT_ALLOCATIONS
+	std::cout << "Steady Frames: " << settled << ", Allocating: " << allocating << std::endl;
+#endif
+}
+
+bool Analyser::prepare(size_t frame, size_t bands, double rate) {
+	bool resized = false;
+	if (plan.Size() != frame) {
+		plan.Create((unsigned int)frame);
+		resized = true;
+	}
+	resized |= incoming.resize((frame + decimator.warmup()) * decimator.factor());
+	resized |= decimated.resize(frame + decimator.warmup() + 1);
+	if (history.resize(2 * frame)) {
+		position = 0;
+		resized = true;
+	}
+	resized |= complexSamples.resize(frame / 2 + 1);
+	resized |= unwindowed.resize(frame / 2 + 1);
+	resized |= windowTable.build(settings.windowType, frame);
+	resized |= power.resize(frame / 2 + 1);
+	resized |= transform.resize(bands);
+	resized |= levels.resize(bands);
+	if (barState.resize(bands)) {
+		// a new bar count starts from the next frame's levels
+		fresh = true;
+		resized = true;
+	}
+	resized |= bandMap.build(bands, frame, rate, settings.maxFrequency, settings.spacing);
+	return resized;
+}
+
+void Analyser::refreshSettings() {
+	// the rate only changes while capture restarts, it needs no lock
+	settings.rate = captureRate;
+	// never wait for the other threads, a busy lock keeps the previous settings
+	if (mutex.try_lock()) {
+		settings.bars = bars;
+		settings.window = windowSize;
+		settings.hop = hopSize;
+		settings.maxFrequency = maxFrequency;
+		settings.spacing = spacing;
+		settings.decimation = decimation;
+		settings.windowType = windowType;
+		settings.peakDecay = peakDecay;
+		settings.peakHold = peakHold;
+		settings.scale1 = scale1;
+		settings.scale2 = scale2;
+		settings.smoothing = smoothing;
+		settings.delayedPeaks = delayedPeaks;
+		settings.decaySmoothing = decaySmoothing;
+		mutex.unlock();
+	}
+}
+
+size_t Analyser::decimationFactor() const {
+	size_t factor = 1;
+	if (settings.decimation) {
+		while (factor < 16 && settings.maxFrequency * 5.0 * factor <= settings.rate && settings.window / (2 * factor) >= 256) {
+			factor *= 2;
+		}
+	}
+	return factor;
+}
+
+void Analyser::run() {
+	while (running) {
+		refreshSettings();
+		const size_t factor = decimationFactor();
+		const size_t frame = settings.window / factor;
+		const size_t bands = settings.bars;
+		// whole steps of the decimated stream, so the recursive update always slides evenly,
+		// a hand-edited settings file must not stall the loop either
+		const size_t hop = std::max<size_t>(settings.hop / factor, 1) * factor;
+		const size_t step = hop / factor;
+		const size_t available = samples.available();
+		if (available < hop) {
+			// a hop is at least a millisecond of audio
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+		// when behind, every whole hop queued is consumed at once
+		// and only the newest frame is analysed
+		const size_t hops = available / hop;
+		if (hops > 1) {
+			late++;
+			skipped += hops - 1;
+		}
+		// a bar count, band, rate or window change reaches this thread between frames
+		bool steady = !decimator.configure(factor);
+		steady &= !prepare(frame, bands, settings.rate / (double)factor);
+		const size_t bins = bandMap.bins();
+		// the recursive update costs about 0.9 ns per sample and bin, a pruned transform
+		// about 0.3 ns per frame sample and stage, so it only pays for short hops
+		// or when few bins are consumed
+		// a cosine-sum window is applied to the tracked bins by convolution,
+		// which needs a few bins more than the bands read
+		const size_t tracked = std::min<size_t>(bins + windowTable.terms() - 1, frame / 2 + 1);
+		const bool recursive = windowTable.cosineSum() && 8 * step * tracked < 3 * frame * log2((double)frame);
+		if (recursive) {
+			steady &= !sliding.resize(frame, tracked, step);
+			steady &= !delta.resize(step);
+		}
+		advance(hops * hop, recursive);
+		analyse(steady, bins, recursive);
+		analysed++;
+	}
+}
+
+void Analyser::advance(size_t count, bool recursive) {
+	const size_t frame = history.size() / 2;
+	// when further behind than a frame, only the newest samples are filtered,
+	// with enough older ones for the filter to settle before the frame starts
+	const size_t span = (frame + decimator.warmup()) * decimator.factor();
+	if (count > span) {
+		samples.discard(count - span);
+		count = span;
+		sliding.invalidate();
+	}
+	if (!recursive) {
+		sliding.invalidate();
+	}
+	samples.pop(incoming.data(), count);
+	// counts are whole multiples of the factor, so this is exactly count / factor
+	count = decimator.process(incoming.data(), count, decimated.data());
+	float* const first = history.data();
+	float* const second = history.data() + frame;
+	const size_t hop = sliding.hop();
+	for (size_t i = 0; i < count; i++) {
+		if (sliding.tracking() && (i % hop) == 0) {
+			// the leaving samples are still contiguous from position on
+			const size_t length = std::min<size_t>(hop, count - i);
+			if (length < hop) {
+				sliding.invalidate();
+			}
+			else {
+				for (size_t n = 0; n < hop; n++) {
+					delta[n] = (double)decimated[i + n] - first[position + n];
+				}
+				sliding.slide(delta.data());
+			}
+		}
+		const float sample = decimated[i];
+		first[position] = sample;
+		second[position] = sample;
+		if (++position == frame) {
+			position = 0;
+		}
+	}
+}
+
+void Analyser::analyse(bool steady, size_t bins, bool recursive)
+{
+#ifdef COUNT_ALLOCATIONS
+	const size_t allocations = threadAllocations();
+#endif
+	const size_t frame = history.size() / 2;
+	const size_t bands = settings.bars;
+
+	// the input is real, so only the non-redundant half of the spectrum is computed,
+	// and butterflies feeding only bins no band reads are skipped
+	if (recursive) {
+		if (sliding.tracking() && sliding.drift() < frame) {
+			sliding.read(unwindowed.data());
+		}
+		else {
+			if (!CFFTF::ForwardRealPruned(plan, history.data() + position, unwindowed.data(), (unsigned int)sliding.bins())) {
+				std::cout << "Error: FFT execution failed" << std::endl;
+				return;
+			}
+			// a full transform every frame bounds the drift of the recursive update
+			sliding.reset(unwindowed.data());
+		}
+		windowTable.convolve(unwindowed.data(), complexSamples.data(), bins);
+	}
+	// otherwise the window is applied while the samples are packed for the transform
+	else if (!CFFTF::ForwardRealWindowed(plan, history.data() + position, windowTable.data(), complexSamples.data(), (unsigned int)bins)) {
+		std::cout << "Error: FFT execution failed" << std::endl;
+		return;
+	}
+
+	// power of every consumed bin in one pass, then gathered into bars
+	spectrumLevels(complexSamples.data(), power.data(), bins, powerLevel);
+	bandMap.apply(power.data(), transform.data());
+
+	// a tone gathers magnitude in proportion to the frame, so its power with the square,
+	// levels are brought back to those of the 15 ms frames the scales were tuned for
+	const double relative = (double)frameSize / (double)frame;
+	const double scale2 = settings.scale2 * relative * relative;
+	// log10(power * scale2) * scale1 for every bar in one pass
+	decibels(transform.data(), levels.data(), bands, (float)settings.scale1, (float)(settings.scale1 * log10(scale2)));
+	if (fresh) {
+		barState.reset(levels.data());
+		fresh = false;
+	}
+	else {
+		BarRules rules;
+		rules.smoothing = (float)settings.smoothing;
+		rules.decaySmoothing = settings.decaySmoothing;
+		rules.delayedPeaks = settings.delayedPeaks;
+		rules.peakDecay = settings.peakDecay;
+		rules.holdFrames = settings.peakHold;
+		barState.update(levels.data(), rules);
+	}
+
+	// hand a complete copy to the rendering thread, each slot
+	// only allocates the first time it sees a larger bar count
+	SpectrumFrame& output = spectrum.write();
+	steady &= output.frequencies.capacity() >= bands && output.peaks.capacity() >= bands;
+	output.frequencies.assign(barState.values(), barState.values() + bands);
+	output.peaks.assign(barState.peaks(), barState.peaks() + bands);
+	output.number = analysed + 1;
+	spectrum.publish();
+
+	// once sized, the analysis path must not touch the heap, the tests
+	// check that no steady frame was counted as allocating
+	if (steady) {
+		settled++;
+#ifdef COUNT_ALLOCATIONS
+		if (threadAllocations() != allocations) {
+			allocating++;
+		}
+#endif
+	}
+}
@@ -0,0 +1,138 @@
+// analyser.h - analysis thread turning captured samples into bar levels
+
+#ifndef AUDIOANALYSER_ANALYSER_H
+#define AUDIOANALYSER_ANALYSER_H
+
+#include "SFML/Config.hpp"
+#include "fft.h"
+#include "buffer.h"
+#include "ringbuffer.h"
+#include "triplebuffer.h"
+#include "slidingdft.h"
+#include "bandmap.h"
+#include "decimator.h"
+#include "windowtable.h"
+#include "barstate.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// one analysed spectrum, filled by the analysis thread and never changed once published
+struct SpectrumFrame
+{
+	SpectrumFrame() : number(0) {}
+
+	std::vector<double> frequencies;
+	std::vector<double> peaks;
+	// counts up from 1, so the reader can tell a new frame from one it has seen
+	uint64_t number;
+};
+
+// pulls captured samples from the ring buffer on its own thread and analyses
+// one frame every hop, so the audio thread only has to copy samples
+class Analyser
+{
+public:
+	// tables for the initial frame are built here, later changes rebuild them between frames
+	Analyser(RingBuffer<sf::Int16>& samples, TripleBuffer<SpectrumFrame>& spectrum);
+
+	Analyser(const Analyser&) = delete;
+	Analyser& operator=(const Analyser&) = delete;
+
+	void start();
+	void stop();
+
+	// frames analysed so far, may be read from any thread
+	uint64_t frames() const { return analysed.load(std::memory_order_relaxed); }
+	// frames that ran without any buffer being resized, and those of them that still
+	// touched the heap, counted only where allocations.h counts allocations
+	uint64_t steadyFrames() const { return settled.load(std::memory_order_relaxed); }
+	uint64_t allocatingFrames() const { return allocating.load(std::memory_order_relaxed); }
+
+private:
+	// copy of the settings the analysis uses, refreshed whenever the lock is free
+	struct Settings
+	{
+		uint32_t rate;
+		size_t bars;
+		size_t window;
+		size_t hop;
+		uint16_t maxFrequency;
+		int spacing;
+		bool decimation;
+		int windowType;
+		uint16_t peakDecay;
+		uint16_t peakHold;
+		double scale1;
+		double scale2;
+		double smoothing;
+		bool delayedPeaks;
+		bool decaySmoothing;
+	} settings;
+
+	RingBuffer<sf::Int16>& samples;
+	TripleBuffer<SpectrumFrame>& spectrum;
+	CFFTPlanF plan;
+	// smoothed levels, peaks and peak holds carried from frame to frame
+	BarState barState;
+	bool fresh;
+	// work buffers reused by every frame, the analysis thread never allocates
+	// while neither the frame size nor the bar count changes
+	AlignedBuffer<sf::Int16> incoming;
+	// low maxFrequency settings analyse a low-passed stream at a fraction of the rate,
+	// the same time span in proportionally fewer samples at the same resolution
+	Decimator decimator;
+	AlignedBuffer<float> decimated;
+	// every sample is written twice, window apart, so the newest window
+	// always lies contiguous at history + position, oldest sample first
+	AlignedBuffer<float> history;
+	size_t position;
+	AlignedBuffer<fcomplex> complexSamples;
+	// spectrum of the frame before windowing, kept while updating recursively
+	AlignedBuffer<fcomplex> unwindowed;
+	WindowTable windowTable;
+	AlignedBuffer<float> power;
+	AlignedBuffer<float> transform;
+	AlignedBuffer<float> levels;
+	// which bins, and how much of each, make up every bar
+	BandMap bandMap;
+	// for short hops the consumed bins are updated sample by sample instead,
+	// from the difference between each entering and leaving sample
+	SlidingDFT<float> sliding;
+	AlignedBuffer<double> delta;
+
+	std::thread thread;
+	std::atomic<bool> running;
+	// frames analysed, hops dropped because analysis fell behind,
+	// and analysis passes that started more than one hop late
+	std::atomic<uint64_t> analysed;
+	uint64_t skipped;
+	uint64_t late;
+	std::atomic<uint64_t> settled;
+	std::atomic<uint64_t> allocating;
+
+	// size plan and buffers for the given frame, bar count and rate of the analysed stream,
+	// returns true if anything had to be allocated
+	bool prepare(size_t frame, size_t bands, double rate);
+
+	void refreshSettings();
+
+	// largest power of two the rate may be divided by while maxFrequency stays below
+	// 0.4 of the divided rate, where the decimator passes everything unchanged,
+	// powers of two keep the frame a whole part of the window
+	size_t decimationFactor() const;
+
+	void run();
+
+	// move count new samples from the ring buffer through the decimator into the history,
+	// a hop costs a few writes per sample however long the frame is,
+	// when recursive the tracked bins slide along one hop at a time
+	void advance(size_t count, bool recursive);
+
+	// steady is false when buffers were just resized for this frame,
+	// recursive when the tracked bins may stand in for a transform
+	void analyse(bool steady, size_t bins, bool recursive);
+};
+
+#endif
@@ -0,0 +1,137 @@
+// bandmap.cpp - band edges for each spacing and the bin weights between them
+
+#include "bandmap.h"
+#include <algorithm>
+#include <cmath>
+
+// the lowest band edge where the spacing cannot start at zero
+static const double lowestFrequency = 20.0;
+
+const char* spacingName(int spacing) {
+	switch (spacing) {
+	case linearSpacing:
+		return "Linear";
+	case logarithmicSpacing:
+		return "Logarithmic";
+	case melSpacing:
+		return "Mel";
+	case octaveSpacing:
+		return "Octave";
+	default:
+		return "Unknown";
+	}
+}
+
+static double toMel(double frequency) {
+	return 2595.0 * log10(1.0 + frequency / 700.0);
+}
+
+static double fromMel(double mel) {
+	return 700.0 * (pow(10.0, mel / 2595.0) - 1.0);
+}
+
+// lower edge of band b out of bands, in Hz, the upper edge is edge(b + 1)
+static double edge(size_t b, size_t bands, double high, int spacing) {
+	const double position = (double)b / (double)bands;
+	switch (spacing) {
+	case logarithmicSpacing:
+		return lowestFrequency * pow(high / lowestFrequency, position);
+	case melSpacing:
+		return fromMel(toMel(high) * position);
+	case octaveSpacing: {
+		// whole fractions of an octave, as many per octave as fit the bars into the range,
+		// aligned to 1 kHz like standard fractional-octave bands, the top band ending
+		// at the last edge not above the highest frequency
+		const double octaves = log2(high / lowestFrequency);
+		const double perOctave = std::max(1.0, floor(bands / octaves + 0.5));
+		const double top = floor(log2(high / 1000.0) * perOctave);
+		return 1000.0 * pow(2.0, (top - (double)(bands - b)) / perOctave);
+	}
+	default:
+		return high * position;
+	}
+}
+
+bool BandMap::build(size_t newBands, size_t newWindow, double sampleRate, double maxFrequency, int newSpacing) {
+	if (newBands == bands && newWindow == window && sampleRate == rate && maxFrequency == high && newSpacing == spacing) {
+		return false;
+	}
+	bands = newBands;
+	window = newWindow;
+	rate = sampleRate;
+	high = maxFrequency;
+	spacing = newSpacing;
+	const double highest = std::min(high, rate / 2);
+
+	// bin k is centred on k * resolution and covers half a bin either side
+	const double resolution = rate / (double)window;
+	const size_t lastBin = window / 2;
+
+	// sizes first, so storage only changes when the layout grows or shrinks
+	bool resized = false;
+	resized |= firsts.resize(bands);
+	resized |= offsets.resize(bands + 1);
+	size_t total = 0;
+	for (size_t b = 0; b < bands; b++) {
+		const double low = edge(b, bands, highest, spacing) / resolution + 0.5;
+		const double top = edge(b + 1, bands, highest, spacing) / resolution + 0.5;
+		const size_t first = std::min<size_t>((size_t)std::max(0.0, floor(low)), lastBin);
+		const size_t last = std::min<size_t>((size_t)std::max(0.0, ceil(top)), lastBin + 1);
+		firsts[b] = first;
+		offsets[b] = total;
+		total += std::max<size_t>(last, first + 1) - first;
+	}
+	offsets[bands] = total;
+	resized |= weights.resize(total);
+
+	consumed = 0;
+	for (size_t b = 0; b < bands; b++) {
+		// band edges in bin units, shifted so bin k spans [k, k + 1)
+		const double low = edge(b, bands, highest, spacing) / resolution + 0.5;
+		const double top = std::max(low, edge(b + 1, bands, highest, spacing) / resolution + 0.5);
+		const size_t count = offsets[b + 1] - offsets[b];
+		float* const row = weights.data() + offsets[b];
+		double sum = 0;
+		for (size_t j = 0; j < count; j++) {
+			const double bin = (double)(firsts[b] + j);
+			const double overlap = std::max(0.0, std::min(top, bin + 1) - std::max(low, bin));
+			row[j] = (float)overlap;
+			sum += overlap;
+		}
+		if (sum > 0) {
+			for (size_t j = 0; j < count; j++) {
+				row[j] = (float)(row[j] / sum);
+			}
+		}
+		else {
+			// an empty or out of range band takes its nearest bin
+			for (size_t j = 0; j < count; j++) {
+				row[j] = 0;
+			}
+			row[std::min<size_t>((size_t)std::max(0.0, low), firsts[b] + count - 1) - firsts[b]] = 1;
+		}
+		consumed = std::max(consumed, firsts[b] + count);
+	}
+	return resized;
+}
+
+void BandMap::apply(const float* const power, float* const result) const {
+	for (size_t b = 0; b < bands; b++) {
+		const float* const row = weights.data() + offsets[b];
+		const float* const values = power + firsts[b];
+		const size_t count = offsets[b + 1] - offsets[b];
+		// four partial sums keep the multiply-adds independent
+		float sums[4] = {};
+		size_t j = 0;
+		for (; j + 4 <= count; j += 4) {
+			sums[0] += row[j] * values[j];
+			sums[1] += row[j + 1] * values[j + 1];
+			sums[2] += row[j + 2] * values[j + 2];
+			sums[3] += row[j + 3] * values[j + 3];
+		}
+		for (; j < count; j++) {
+			sums[0] += row[j] * values[j];
+		}
+		result[b] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	}
+}
@@ -0,0 +1,56 @@
+// bandmap.h - precomputed weights gathering spectrum bins into bars
+
+#ifndef AUDIOANALYSER_BANDMAP_H
+#define AUDIOANALYSER_BANDMAP_H
+
+#include "buffer.h"
+#include <cstddef>
+
+// how band edges are spread between the lowest and highest frequency
+enum BandSpacing
+{
+	linearSpacing,
+	logarithmicSpacing,
+	melSpacing,
+	octaveSpacing,
+	spacingCount
+};
+
+const char* spacingName(int spacing);
+
+// sparse matrix of fractional bin weights, one row per bar; each row covers a contiguous
+// run of bins, weighted by how much of every bin lies inside the band and normalised to
+// sum to one, so a band narrower than a bin still takes that bin's value
+class BandMap
+{
+public:
+	BandMap() : bands(0), window(0), rate(0), high(0), spacing(-1), consumed(0) {}
+
+	BandMap(const BandMap&) = delete;
+	BandMap& operator=(const BandMap&) = delete;
+
+	// rebuild for bands bars up to maxFrequency over the spectrum of a window sampled at
+	// sampleRate, nothing happens while the arguments stay the same,
+	// returns true if storage had to be allocated
+	bool build(size_t bands, size_t window, double sampleRate, double maxFrequency, int spacing);
+
+	// bins [0, bins) are the only ones any band reads
+	size_t bins() const { return consumed; }
+
+	// result[band] = sum of weight * power[bin] over the band's row
+	void apply(const float* power, float* result) const;
+
+private:
+	size_t bands;
+	size_t window;
+	double rate;
+	double high;
+	int spacing;
+	size_t consumed;
+	// row b holds weights[offsets[b], offsets[b + 1]) for bins from firsts[b] on
+	AlignedBuffer<size_t> firsts;
+	AlignedBuffer<size_t> offsets;
+	AlignedBuffer<float> weights;
+};
+
+#endif
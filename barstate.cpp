@@ -0,0 +1,97 @@
+// barstate.cpp - scalar and SSE2 forms of the bar smoothing and peak rules
+
+#include "barstate.h"
+#include "simd.h"
+
+bool BarState::resize(size_t bars) {
+	bool resized = false;
+	resized |= value.resize(bars);
+	resized |= peak.resize(bars);
+	resized |= hold.resize(bars);
+	count = bars;
+	return resized;
+}
+
+void BarState::reset(const float* const levels) {
+	for (size_t i = 0; i < count; i++) {
+		value[i] = levels[i];
+		peak[i] = levels[i];
+		hold[i] = 0;
+	}
+}
+
+void BarState::updateScalar(float* const value, float* const peak, float* const hold, const float* const levels,
+	size_t begin, size_t end, const BarRules& rules) {
+	const float keep = rules.smoothing;
+	const float take = 1 - rules.smoothing;
+	for (size_t i = begin; i < end; i++) {
+		const float level = levels[i];
+		if (rules.decaySmoothing && level > value[i]) {
+			value[i] = level;
+		}
+		else {
+			value[i] = value[i] * keep + level * take;
+		}
+		if (rules.delayedPeaks) {
+			if (value[i] > peak[i]) {
+				peak[i] = value[i];
+				hold[i] = rules.holdFrames;
+			}
+			else if (hold[i] > 0) {
+				hold[i] -= 1;
+			}
+			else if (peak[i] > 1) {
+				peak[i] -= rules.peakDecay;
+				if (value[i] > peak[i]) {
+					peak[i] = value[i];
+				}
+			}
+		}
+	}
+}
+
+void BarState::updateReference(const float* const levels, const BarRules& rules) {
+	updateScalar(value.data(), peak.data(), hold.data(), levels, 0, count, rules);
+}
+
+#if SIMD_SSE2
+// mask ? a : b
+static inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#endif
+
+void BarState::update(const float* const levels, const BarRules& rules) {
+	size_t i = 0;
+#if SIMD_SSE2
+	const __m128 keep = _mm_set1_ps(rules.smoothing);
+	const __m128 take = _mm_set1_ps(1 - rules.smoothing);
+	const __m128 decayOnly = _mm_castsi128_ps(_mm_set1_epi32(rules.decaySmoothing ? -1 : 0));
+	const __m128 peakDecay = _mm_set1_ps(rules.peakDecay);
+	const __m128 holdFrames = _mm_set1_ps(rules.holdFrames);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1);
+	for (; i + 4 <= count; i += 4) {
+		const __m128 level = _mm_loadu_ps(levels + i);
+		__m128 current = _mm_load_ps(value.data() + i);
+		const __m128 blended = _mm_add_ps(_mm_mul_ps(current, keep), _mm_mul_ps(level, take));
+		current = select(_mm_and_ps(decayOnly, _mm_cmpgt_ps(level, current)), level, blended);
+		_mm_store_ps(value.data() + i, current);
+		if (rules.delayedPeaks) {
+			const __m128 top = _mm_load_ps(peak.data() + i);
+			const __m128 frames = _mm_load_ps(hold.data() + i);
+			const __m128 rising = _mm_cmpgt_ps(current, top);
+			const __m128 holding = _mm_cmpgt_ps(frames, zero);
+			// neither rising nor held, and above the floor
+			const __m128 falling = _mm_andnot_ps(_mm_or_ps(rising, holding), _mm_cmpgt_ps(top, one));
+			__m128 next = select(falling, _mm_sub_ps(top, peakDecay), top);
+			next = select(_mm_and_ps(falling, _mm_cmpgt_ps(current, next)), current, next);
+			next = select(rising, current, next);
+			const __m128 counted = select(_mm_andnot_ps(rising, holding), _mm_sub_ps(frames, one), frames);
+			_mm_store_ps(peak.data() + i, next);
+			_mm_store_ps(hold.data() + i, select(rising, holdFrames, counted));
+		}
+	}
+#endif
+	updateScalar(value.data(), peak.data(), hold.data(), levels, i, count, rules);
+}
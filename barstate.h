@@ -0,0 +1,63 @@
+// barstate.h - smoothed level, peak and peak hold of every bar, updated a register at a time
+
+#ifndef AUDIOANALYSER_BARSTATE_H
+#define AUDIOANALYSER_BARSTATE_H
+
+#include "buffer.h"
+#include <cstddef>
+
+// smoothing and peak rules applied to every bar each frame
+struct BarRules
+{
+	// share of the previous level kept, 0 follows the new level at once
+	float smoothing;
+	// decay-only smoothing lets rising levels through unsmoothed
+	bool decaySmoothing;
+	// peaks follow rising levels, then wait holdFrames frames
+	// and fall by peakDecay per frame while above 1
+	bool delayedPeaks;
+	float peakDecay;
+	float holdFrames;
+};
+
+// state kept as separate aligned arrays, so one SSE2 register holds four bars of the same
+// field and the rules become masks and blends instead of branches; tests/barstatetests.cpp
+// checks the result against the scalar rules bit for bit
+class BarState
+{
+public:
+	BarState() : count(0) {}
+
+	BarState(const BarState&) = delete;
+	BarState& operator=(const BarState&) = delete;
+
+	// size for the given bar count, returns true if it changed, the state must be reset then
+	bool resize(size_t bars);
+
+	// start every bar at the given level with its peak on it
+	void reset(const float* levels);
+
+	// apply one frame of levels
+	void update(const float* levels, const BarRules& rules);
+
+	// the same frame with the scalar rules for every bar, what update must match bit for bit
+	void updateReference(const float* levels, const BarRules& rules);
+
+	size_t size() const { return count; }
+	const float* values() const { return value.data(); }
+	const float* peaks() const { return peak.data(); }
+	const float* holds() const { return hold.data(); }
+
+private:
+	// the rules one bar at a time, for the tail and as the reference of the vector kernel
+	static void updateScalar(float* value, float* peak, float* hold, const float* levels,
+		size_t begin, size_t end, const BarRules& rules);
+
+	size_t count;
+	AlignedBuffer<float> value;
+	AlignedBuffer<float> peak;
+	// frames left before the peak may fall
+	AlignedBuffer<float> hold;
+};
+
+#endif
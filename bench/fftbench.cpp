@@ -0,0 +1,121 @@
+// fftbench.cpp - timing of every planned FFT engine and instruction set against the
+// unplanned transform, forward and out of place, for lengths 2^10 to 2^20
+//
+// build the FFTBench project in Release and run it from a console, "double" or "float"
+// limits the run to one precision; each figure is the median of seven batches in
+// microseconds per transform, a batch repeating the transform for at least 20 ms,
+// and a dash marks an instruction set the CPU does not have
+
+#include "../fft.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const unsigned int firstLength = 1u << 10;
+static const unsigned int lastLength = 1u << 20;
+static const int batches = 7;
+static const double batchSeconds = 0.02;
+
+// median over the batches of the time of one call of transform, in microseconds
+template <class F>
+static double measure(F transform) {
+	typedef std::chrono::steady_clock clock;
+	// one untimed call warms the caches and the plan's scratch space
+	transform();
+	size_t repeats = 1;
+	for (;;) {
+		const clock::time_point start = clock::now();
+		for (size_t i = 0; i < repeats; i++) {
+			transform();
+		}
+		if (std::chrono::duration<double>(clock::now() - start).count() >= batchSeconds) {
+			break;
+		}
+		repeats *= 2;
+	}
+	double times[batches];
+	for (int b = 0; b < batches; b++) {
+		const clock::time_point start = clock::now();
+		for (size_t i = 0; i < repeats; i++) {
+			transform();
+		}
+		times[b] = std::chrono::duration<double, std::micro>(clock::now() - start).count() / repeats;
+	}
+	std::sort(times, times + batches);
+	return times[batches / 2];
+}
+
+template <class T>
+static void run(const char* precision) {
+	typedef TFFT<T> FFT;
+	typedef typename FFT::complex complex;
+	const CFFTBase::Algorithms algorithms[] = { CFFTBase::Radix2, CFFTBase::Radix4, CFFTBase::Stockham };
+	const char* const algorithmNames[] = { "r2", "r4", "st" };
+	const CFFTBase::Instructions sets[] = { CFFTBase::Scalar, CFFTBase::SSE2, CFFTBase::AVX2 };
+	const char* const setNames[] = { "scalar", "SSE2", "AVX2" };
+
+	std::printf("%s precision, microseconds per forward transform\n", precision);
+	std::printf("%8s %11s", "N", "unplanned");
+	for (int a = 0; a < 3; a++) {
+		for (int s = 0; s < 3; s++) {
+			char name[16];
+			std::snprintf(name, sizeof(name), "%s %s", algorithmNames[a], setNames[s]);
+			std::printf(" %11s", name);
+		}
+	}
+	std::printf("\n");
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<double> uniform(-1, 1);
+	for (unsigned int n = firstLength; n <= lastLength; n *= 2) {
+		std::vector<complex> input(n), output(n);
+		for (unsigned int i = 0; i < n; i++) {
+			input[i] = complex((T)uniform(random), (T)uniform(random));
+		}
+		std::printf("%8u", n);
+		std::fflush(stdout);
+
+		// the transform the planned engines replaced, scalar radix-2 with factors by recurrence
+		CFFTBase::SetAlgorithm(CFFTBase::Radix2);
+		CFFTBase::SetInstructions(CFFTBase::Scalar);
+		std::printf(" %11.1f", measure([&]() { FFT::Forward(input.data(), output.data(), n); }));
+		std::fflush(stdout);
+
+		const typename FFT::CFFTPlan plan(n);
+		for (int a = 0; a < 3; a++) {
+			for (int s = 0; s < 3; s++) {
+				CFFTBase::SetAlgorithm(algorithms[a]);
+				CFFTBase::SetInstructions(sets[s]);
+				if (CFFTBase::GetInstructions() != sets[s]) {
+					std::printf(" %11s", "-");
+				}
+				else {
+					std::printf(" %11.1f", measure([&]() { FFT::Forward(plan, input.data(), output.data()); }));
+				}
+				std::fflush(stdout);
+			}
+		}
+		std::printf("\n");
+	}
+	std::printf("\n");
+}
+
+int main(int argc, char** argv) {
+	const bool onlyDouble = argc > 1 && std::strcmp(argv[1], "double") == 0;
+	const bool onlyFloat = argc > 1 && std::strcmp(argv[1], "float") == 0;
+	// the best set the CPU has, restored after each precision
+	CFFTBase::SetInstructions(CFFTBase::AVX2);
+	const CFFTBase::Instructions best = CFFTBase::GetInstructions();
+	if (!onlyFloat) {
+		run<double>("double");
+		CFFTBase::SetInstructions(best);
+	}
+	if (!onlyDouble) {
+		run<float>("single");
+		CFFTBase::SetInstructions(best);
+	}
+	return 0;
+}
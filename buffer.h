@@ -0,0 +1,61 @@
+// buffer.h - aligned work buffer that keeps its storage between uses
+
+#ifndef AUDIOANALYSER_BUFFER_H
+#define AUDIOANALYSER_BUFFER_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+// owns an array of plain values on an alignment byte boundary, so SIMD kernels
+// can stream over it and nothing is freed or allocated between frames
+template <class T, size_t alignment = 64>
+class AlignedBuffer
+{
+	static_assert(std::is_trivially_destructible<T>::value, "AlignedBuffer holds plain values only");
+
+public:
+	AlignedBuffer() : values(nullptr), count(0) {}
+	explicit AlignedBuffer(size_t size) : values(nullptr), count(0) { resize(size); }
+	~AlignedBuffer() { release(); }
+
+	AlignedBuffer(const AlignedBuffer&) = delete;
+	AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+	// storage is only replaced when the size changes,
+	// returns true if it was, the contents are reset then
+	bool resize(size_t size) {
+		if (size == count) {
+			return false;
+		}
+		release();
+		if (size > 0) {
+			values = static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(alignment)));
+			for (size_t i = 0; i < size; i++) {
+				new (values + i) T();
+			}
+			count = size;
+		}
+		return true;
+	}
+
+	size_t size() const { return count; }
+	T* data() { return values; }
+	const T* data() const { return values; }
+	T& operator[](size_t i) { return values[i]; }
+	const T& operator[](size_t i) const { return values[i]; }
+
+private:
+	void release() {
+		if (values) {
+			::operator delete(values, std::align_val_t(alignment));
+		}
+		values = nullptr;
+		count = 0;
+	}
+
+	T* values;
+	size_t count;
+};
+
+#endif
@@ -8,6 +8,6 @@
 //   Include header file
 #include "complex.h"
 
-//   Imaginary unity constants
-const complex complex::i(0., 1.);
-const complex complex::j(0., 1.);
\ No newline at end of file
+//   Double and single precision instantiations
+template class tcomplex<double>;
+template class tcomplex<float>;
\ No newline at end of file
@@ -0,0 +1,73 @@
+// decimator.cpp - filter design and the decimating dot products
+
+#include "decimator.h"
+#include <cmath>
+#include <cstring>
+
+bool Decimator::configure(size_t factor) {
+	if (factor == decimation) {
+		return false;
+	}
+	decimation = factor;
+	// a Blackman window this long narrows the transition to about 0.2 of the decimated rate,
+	// enough to keep aliases above 0.4 of it, with a stopband near -74 dB
+	taps = factor > 1 ? 28 * factor + 1 : 1;
+
+	bool resized = false;
+	resized |= coefficients.resize(taps);
+	resized |= line.resize(taps - 1 + block);
+
+	const double pi = 3.14159265358979323846;
+	const double cutoff = 0.5 / factor;
+	const double middle = (taps - 1) / 2.0;
+	double sum = 0;
+	for (size_t i = 0; i < taps; i++) {
+		const double t = i - middle;
+		const double sinc = t == 0 ? 2 * cutoff : sin(2 * pi * cutoff * t) / (pi * t);
+		const double window = taps > 1 ? 0.42 - 0.5 * cos(2 * pi * i / (taps - 1)) + 0.08 * cos(4 * pi * i / (taps - 1)) : 1;
+		coefficients[taps - 1 - i] = (float)(sinc * window);
+		sum += sinc * window;
+	}
+	// unit gain at DC, so levels match the undecimated path
+	for (size_t i = 0; i < taps; i++) {
+		coefficients[i] = (float)(coefficients[i] / sum);
+	}
+	for (size_t i = 0; i < line.size(); i++) {
+		line[i] = 0;
+	}
+	pending = 0;
+	return resized;
+}
+
+size_t Decimator::process(const int16_t* const input, size_t count, float* const output) {
+	const size_t history = taps - 1;
+	float* const newest = line.data() + history;
+	size_t written = 0;
+	for (size_t start = 0; start < count; start += block) {
+		const size_t length = count - start < block ? count - start : block;
+		for (size_t i = 0; i < length; i++) {
+			newest[i] = input[start + i];
+		}
+		// output at input n reads line[n, n + taps), the input itself being the last
+		size_t n = pending;
+		for (; n < length; n += decimation) {
+			const float* const values = line.data() + n;
+			float sums[4] = {};
+			size_t j = 0;
+			for (; j + 4 <= taps; j += 4) {
+				sums[0] += coefficients[j] * values[j];
+				sums[1] += coefficients[j + 1] * values[j + 1];
+				sums[2] += coefficients[j + 2] * values[j + 2];
+				sums[3] += coefficients[j + 3] * values[j + 3];
+			}
+			for (; j < taps; j++) {
+				sums[0] += coefficients[j] * values[j];
+			}
+			output[written++] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+		}
+		pending = n - length;
+		// keep the newest inputs as history for the next block
+		std::memmove(line.data(), line.data() + length, history * sizeof(float));
+	}
+	return written;
+}
@@ -0,0 +1,50 @@
+// decimator.h - streaming low-pass filter that keeps one sample in every factor
+
+#ifndef AUDIOANALYSER_DECIMATOR_H
+#define AUDIOANALYSER_DECIMATOR_H
+
+#include "buffer.h"
+#include <cstddef>
+#include <cstdint>
+
+// windowed-sinc low-pass cut at the decimated Nyquist frequency, evaluated only at the
+// kept outputs, each one a dot product of the taps with the newest inputs; anything that
+// still aliases folds down above 0.4 of the decimated rate, where no band reads,
+// a factor of one just converts samples
+class Decimator
+{
+public:
+	Decimator() : decimation(0), taps(0), pending(0) {}
+
+	Decimator(const Decimator&) = delete;
+	Decimator& operator=(const Decimator&) = delete;
+
+	// design the filter for the given factor and clear the input history,
+	// nothing happens while the factor stays the same,
+	// returns true if storage had to be allocated
+	bool configure(size_t factor);
+
+	size_t factor() const { return decimation; }
+
+	// outputs after a cleared history before the filter has seen all its taps
+	size_t warmup() const { return (taps + decimation - 1) / decimation; }
+
+	// filter count samples and write every factor-th output, returns how many were written,
+	// at most count / factor + 1, the input phase carries over between calls
+	size_t process(const int16_t* input, size_t count, float* output);
+
+private:
+	// inputs taken per pass through the line
+	static const size_t block = 4096;
+
+	size_t decimation;
+	size_t taps;
+	// inputs to skip before the next kept output
+	size_t pending;
+	// coefficients in reverse order, so an output is a forward dot product
+	AlignedBuffer<float> coefficients;
+	// the last taps - 1 inputs followed by the current block
+	AlignedBuffer<float> line;
+};
+
+#endif
@@ -1,4 +1,4 @@
-//   fft.cpp - impelementation of class
+//   fft.cpp - impelementation of class templates
 //   of fast Fourier transform - FFT
 //
 //   The code is property of LIBROW
@@ -7,14 +7,106 @@
 
 //   Include declaration file
 #include "fft.h"
+//   Include vectorized kernels
+#include "fftkernels.h"
+//   Include generic kernels for the scalar path
+#include "fftsimd.h"
 //   Include math library
 #include <math.h>
 
+#if FFT_SIMD
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+//   Best instruction set supported by the CPU and the OS
+static CFFTBase::Instructions DetectInstructions()
+{
+#if FFT_SIMD && !defined(FFT_FORCE_SCALAR)
+	int Info[4];
+#if defined(_MSC_VER)
+	__cpuidex(Info, 0, 0);
+#else
+	__cpuid_count(0, 0, Info[0], Info[1], Info[2], Info[3]);
+#endif
+	const int Leaves = Info[0];
+#if defined(_MSC_VER)
+	__cpuidex(Info, 1, 0);
+#else
+	__cpuid_count(1, 0, Info[0], Info[1], Info[2], Info[3]);
+#endif
+	//   SSE2 is EDX bit 26
+	if (!(Info[3] & (1 << 26)))
+		return CFFTBase::Scalar;
+	//   FMA, OSXSAVE and AVX are ECX bits 12, 27 and 28
+	const int Features = (1 << 12) | (1 << 27) | (1 << 28);
+	if ((Info[2] & Features) != Features || Leaves < 7)
+		return CFFTBase::SSE2;
+	//   The OS must save XMM and YMM registers
+#if defined(_MSC_VER)
+	const unsigned long long Saved = _xgetbv(0);
+#else
+	unsigned int Low, High;
+	__asm__ volatile ("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+	const unsigned long long Saved = ((unsigned long long)High << 32) | Low;
+#endif
+	if ((Saved & 6) != 6)
+		return CFFTBase::SSE2;
+	//   AVX2 is EBX bit 5 of leaf 7
+#if defined(_MSC_VER)
+	__cpuidex(Info, 7, 0);
+#else
+	__cpuid_count(7, 0, Info[0], Info[1], Info[2], Info[3]);
+#endif
+	return Info[1] & (1 << 5) ? CFFTBase::AVX2 : CFFTBase::SSE2;
+#else
+	return CFFTBase::Scalar;
+#endif
+}
+
+//   Supported and currently selected instruction sets
+static const CFFTBase::Instructions Supported = DetectInstructions();
+static CFFTBase::Instructions Selected = Supported;
+
+//   INSTRUCTION SET SELECTION
+//     Set - preferred instruction set, falls back to the best
+//           one supported by the CPU, Scalar forces the scalar path
+void CFFTBase::SetInstructions(const Instructions Set)
+{
+	Selected = Set < Supported ? Set : Supported;
+}
+
+//   Instruction set in use, detected by CPUID at startup
+CFFTBase::Instructions CFFTBase::GetInstructions()
+{
+	return Selected;
+}
+
+//   Engine of planned transforms
+static CFFTBase::Algorithms Algorithm = CFFTBase::Radix4;
+
+//   ENGINE SELECTION
+//     Algorithm - engine used by planned transforms
+void CFFTBase::SetAlgorithm(const Algorithms Algorithm)
+{
+	::Algorithm = Algorithm;
+}
+
+//   Engine in use, radix-4 by default
+CFFTBase::Algorithms CFFTBase::GetAlgorithm()
+{
+	return Algorithm;
+}
+
 //   FORWARD FOURIER TRANSFORM
 //     Input  - input data
 //     Output - transform result
 //     N      - length of both input data and result
-bool CFFT::Forward(const complex *const Input, complex *const Output, const unsigned int N)
+template <class T>
+bool TFFT<T>::Forward(const complex *const Input, complex *const Output, const unsigned int N)
 {
 	//   Check input parameters
 	if (!Input || !Output || N < 1 || N & (N - 1))
@@ -30,7 +122,8 @@ bool CFFT::Forward(const complex *const Input, complex *const Output, const unsi
 //   FORWARD FOURIER TRANSFORM, INPLACE VERSION
 //     Data - both input data and output
 //     N    - length of input data
-bool CFFT::Forward(complex *const Data, const unsigned int N)
+template <class T>
+bool TFFT<T>::Forward(complex *const Data, const unsigned int N)
 {
 	//   Check input parameters
 	if (!Data || N < 1 || N & (N - 1))
@@ -48,7 +141,8 @@ bool CFFT::Forward(complex *const Data, const unsigned int N)
 //     Output - transform result
 //     N      - length of both input data and result
 //     Scale  - if to scale result
-bool CFFT::Inverse(const complex *const Input, complex *const Output, const unsigned int N, const bool Scale /* = true */)
+template <class T>
+bool TFFT<T>::Inverse(const complex *const Input, complex *const Output, const unsigned int N, const bool Scale /* = true */)
 {
 	//   Check input parameters
 	if (!Input || !Output || N < 1 || N & (N - 1))
@@ -59,7 +153,7 @@ bool CFFT::Inverse(const complex *const Input, complex *const Output, const unsi
 	Perform(Output, N, true);
 	//   Scale if necessary
 	if (Scale)
-		CFFT::Scale(Output, N);
+		TFFT::Scale(Output, N);
 	//   Succeeded
 	return true;
 }
@@ -68,7 +162,8 @@ bool CFFT::Inverse(const complex *const Input, complex *const Output, const unsi
 //     Data  - both input data and output
 //     N     - length of both input data and result
 //     Scale - if to scale result
-bool CFFT::Inverse(complex *const Data, const unsigned int N, const bool Scale /* = true */)
+template <class T>
+bool TFFT<T>::Inverse(complex *const Data, const unsigned int N, const bool Scale /* = true */)
 {
 	//   Check input parameters
 	if (!Data || N < 1 || N & (N - 1))
@@ -79,13 +174,448 @@ bool CFFT::Inverse(complex *const Data, const unsigned int N, const bool Scale /
 	Perform(Data, N, true);
 	//   Scale if necessary
 	if (Scale)
-		CFFT::Scale(Data, N);
+		TFFT::Scale(Data, N);
+	//   Succeeded
+	return true;
+}
+
+//   PLAN CREATION
+//     N - transform length, powers of two run radix-2/4 engines,
+//         products of 2, 3, 5 and 7 the mixed-radix engine
+//         and any other length Bluestein's algorithm
+template <class T>
+bool TFFTPlan<T>::Create(const unsigned int N)
+{
+	//   Check input parameters
+	if (N < 1 || N > 0x40000000)
+		return false;
+	m_N = N;
+	m_Length = 0;
+	m_Permutation.clear();
+	m_Twiddles.clear();
+	m_Triples.clear();
+	m_Factors.clear();
+	m_Roots.clear();
+	m_Chirp.clear();
+	m_Kernel.clear();
+	const double pi = 3.14159265358979323846;
+	if (N & (N - 1))
+	{
+		//   Split into radices 4, 2, 3, 5 and 7, fours first
+		//   as they need the fewest passes
+		static const unsigned int Radices[] = { 4, 2, 3, 5, 7 };
+		unsigned int Rest = N;
+		for (unsigned int Index = 0; Index < sizeof(Radices) / sizeof(Radices[0]); ++Index)
+			while (Rest % Radices[Index] == 0)
+			{
+				m_Factors.push_back(Radices[Index]);
+				Rest /= Radices[Index];
+			}
+		if (Rest == 1)
+		{
+			//   Mixed radix - one root table serves every stage,
+			//   Stockham ping-pong plus staging of real input
+			m_Roots.resize(N);
+			for (unsigned int Power = 0; Power < N; ++Power)
+				m_Roots[Power] = tcomplex<T>(T(cos(-2. * pi * Power / N)), T(sin(-2. * pi * Power / N)));
+			m_Work.resize(2 * N);
+			return true;
+		}
+		//   Bluestein - linear convolution of length 2N - 1 done by
+		//   a power-of-two transform
+		m_Factors.clear();
+		m_Length = 1;
+		while (m_Length < 2 * N - 1)
+			m_Length <<= 1;
+		//   n^2 is reduced modulo 2N before the angle is formed,
+		//   large phases would lose precision otherwise
+		m_Chirp.resize(N);
+		for (unsigned int Position = 0; Position < N; ++Position)
+		{
+			const double Phase = double((unsigned long long)Position * Position % (2ull * N));
+			m_Chirp[Position] = tcomplex<T>(T(cos(-pi * Phase / N)), T(sin(-pi * Phase / N)));
+		}
+		//   Filter is the conjugate chirp wrapped around, its spectrum is
+		//   computed once in double precision by a planned transform, whose
+		//   directly evaluated factors keep recurrence drift out of the kernel
+		std::vector<complex> Filter(m_Length);
+		for (unsigned int Position = 0; Position < N; ++Position)
+		{
+			const double Phase = double((unsigned long long)Position * Position % (2ull * N));
+			Filter[Position] = complex(cos(pi * Phase / N), sin(pi * Phase / N));
+			if (Position)
+				Filter[m_Length - Position] = Filter[Position];
+		}
+		const CFFTPlan FilterPlan(m_Length);
+		CFFT::Forward(FilterPlan, Filter.data());
+		m_Kernel.resize(m_Length);
+		for (unsigned int Position = 0; Position < m_Length; ++Position)
+			m_Kernel[Position] = tcomplex<T>(T(Filter[Position].re() / m_Length), T(Filter[Position].im() / m_Length));
+		//   Convolution buffer plus staging of real input
+		m_Work.resize(m_Length + N);
+	}
+	else
+	{
+		m_Length = N;
+		m_Work.resize(N);
+	}
+	//   Tables of the power-of-two engines
+	const unsigned int Length = m_Length;
+	//   Permutation - same mask walking as in rearrange function
+	m_Permutation.resize(Length);
+	unsigned int Target = 0;
+	for (unsigned int Position = 0; Position < Length; ++Position)
+	{
+		m_Permutation[Position] = Target;
+		unsigned int Mask = Length;
+		while (Target & (Mask >>= 1))
+			Target &= ~Mask;
+		Target |= Mask;
+	}
+	//   Transform factors, one table per stage
+	m_Twiddles.resize(Length > 1 ? Length - 1 : 0);
+	if (Length > 1)
+	{
+		//   The last stage is evaluated directly, no recurrence drift
+		const unsigned int Last = Length >> 1;
+		const double delta = -pi / double(Last);
+		for (unsigned int Group = 0; Group < Last; ++Group)
+			m_Twiddles[Last - 1 + Group] = tcomplex<T>(T(cos(delta * Group)), T(sin(delta * Group)));
+		//   Every earlier stage takes each second factor of the next one
+		for (unsigned int Step = Last >> 1; Step > 0; Step >>= 1)
+			for (unsigned int Group = 0; Group < Step; ++Group)
+				m_Twiddles[Step - 1 + Group] = m_Twiddles[2 * Step - 1 + 2 * Group];
+	}
+	//   Factors W^3g of radix-4 stages, taken from the last stage
+	//   table with W^(N/2 + k) = -W^k
+	m_Triples.resize(Length > 1 ? Length >> 1 : 0);
+	for (unsigned int Quarter = 1; Quarter < (Length >> 1); Quarter <<= 1)
+		for (unsigned int Group = 0; Group < Quarter; ++Group)
+		{
+			const unsigned int Power = 3 * Group * (Length / (4 * Quarter));
+			const tcomplex<T> *const Last = &m_Twiddles[(Length >> 1) - 1];
+			m_Triples[Quarter - 1 + Group] = Power < (Length >> 1) ? Last[Power] : Last[Power - (Length >> 1)] * T(-1);
+		}
+	//   Succeeded
+	return true;
+}
+
+//   FORWARD FOURIER TRANSFORM WITH PLAN
+//     Plan   - precomputed plan, defines length
+//     Input  - input data
+//     Output - transform result
+template <class T>
+bool TFFT<T>::Forward(const CFFTPlan &Plan, const complex *const Input, complex *const Output)
+{
+	//   Check input parameters
+	if (!Input || !Output || Plan.Size() < 1)
+		return false;
+	//   Call FFT implementation
+	Transform(Plan, Input, Output, false);
+	//   Succeeded
+	return true;
+}
+
+//   FORWARD FOURIER TRANSFORM WITH PLAN, INPLACE VERSION
+//     Plan - precomputed plan, defines length
+//     Data - both input data and output
+template <class T>
+bool TFFT<T>::Forward(const CFFTPlan &Plan, complex *const Data)
+{
+	//   Check input parameters
+	if (!Data || Plan.Size() < 1)
+		return false;
+	//   Call FFT implementation
+	Transform(Plan, Data, Data, false);
+	//   Succeeded
+	return true;
+}
+
+//   INVERSE FOURIER TRANSFORM WITH PLAN
+//     Plan   - precomputed plan, defines length
+//     Input  - input data
+//     Output - transform result
+//     Scale  - if to scale result
+template <class T>
+bool TFFT<T>::Inverse(const CFFTPlan &Plan, const complex *const Input, complex *const Output, const bool Scale /* = true */)
+{
+	//   Check input parameters
+	if (!Input || !Output || Plan.Size() < 1)
+		return false;
+	//   Call FFT implementation
+	Transform(Plan, Input, Output, true);
+	//   Scale if necessary
+	if (Scale)
+		TFFT::Scale(Output, Plan.Size());
+	//   Succeeded
+	return true;
+}
+
+//   INVERSE FOURIER TRANSFORM WITH PLAN, INPLACE VERSION
+//     Plan  - precomputed plan, defines length
+//     Data  - both input data and output
+//     Scale - if to scale result
+template <class T>
+bool TFFT<T>::Inverse(const CFFTPlan &Plan, complex *const Data, const bool Scale /* = true */)
+{
+	//   Check input parameters
+	if (!Data || Plan.Size() < 1)
+		return false;
+	//   Call FFT implementation
+	Transform(Plan, Data, Data, true);
+	//   Scale if necessary
+	if (Scale)
+		TFFT::Scale(Data, Plan.Size());
+	//   Succeeded
+	return true;
+}
+
+//   FORWARD FOURIER TRANSFORM OF REAL DATA WITH PLAN
+//     Plan   - precomputed plan, defines length N of real input
+//     Input  - N real input samples
+//     Output - N / 2 + 1 non-redundant bins of the result
+template <class T>
+bool TFFT<T>::ForwardReal(const CFFTPlan &Plan, const T *const Input, complex *const Output)
+{
+	//   Pruned version with every bin kept
+	return ForwardRealPruned(Plan, Input, Output, (Plan.Size() >> 1) + 1);
+}
+
+//   FORWARD FOURIER TRANSFORM WITH PLAN, OUTPUT-PRUNED VERSION
+//     Plan   - precomputed plan, defines length N
+//     Input  - input data
+//     Output - N entries of working storage, only the first Bins
+//              entries hold the transform result
+//     Bins   - count of low bins needed
+template <class T>
+bool TFFT<T>::ForwardPruned(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+	const unsigned int Bins)
+{
+	const unsigned int N = Plan.Size();
+	//   Check input parameters
+	if (!Input || !Output || Bins < 1 || Bins > N)
+		return false;
+	//   Bluestein prunes its inverse convolution, mixed radix runs in full
+	if (Plan.m_Length != N)
+	{
+		if (Plan.m_Factors.empty())
+			Chirp(Plan, Input, Output, N, Bins, false);
+		else
+			Mix(Plan, Input, Output, Plan.m_Work.data(), false);
+		return true;
+	}
+	//   Initialize data
+	if (Input == Output)
+		Rearrange(Plan, Output);
+	else
+		Rearrange(Plan, Input, Output);
+	//   Call FFT implementation
+	Prune(Plan, Output, N, 1, Bins, false);
+	//   Succeeded
+	return true;
+}
+
+//   FORWARD FOURIER TRANSFORM OF REAL DATA WITH PLAN, OUTPUT-PRUNED VERSION
+//     Plan   - precomputed plan, defines length N of real input
+//     Input  - N real input samples
+//     Output - N / 2 + 1 entries of working storage, only the first
+//              Bins entries hold the transform result
+//     Bins   - count of low bins needed, at most N / 2 + 1
+template <class T>
+bool TFFT<T>::ForwardRealPruned(const CFFTPlan &Plan, const T *const Input, complex *const Output,
+	const unsigned int Bins)
+{
+	//   Padded version with no padding
+	return ForwardRealPadded(Plan, Input, Plan.Size(), Output, Bins);
+}
+
+//   FORWARD FOURIER TRANSFORM WITH PLAN, INPUT-PRUNED VERSION
+//     Plan   - precomputed plan, defines length N
+//     Input  - Count leading input samples, the rest are zeros,
+//              must not overlap Output
+//     Count  - count of non-zero leading samples, 1 to N
+//     Output - transform result, N entries
+template <class T>
+bool TFFT<T>::ForwardPadded(const CFFTPlan &Plan, const complex *const Input, const unsigned int Count,
+	complex *const Output)
+{
+	const unsigned int N = Plan.Size();
+	//   Check input parameters
+	if (!Input || !Output || Count < 1 || Count > N)
+		return false;
+	//   Bluestein reads only the leading samples, mixed radix runs in full
+	if (Plan.m_Length != N)
+	{
+		if (Plan.m_Factors.empty())
+			Chirp(Plan, Input, Output, Count, N, false);
+		else
+		{
+			for (unsigned int Position = 0; Position < N; ++Position)
+				Output[Position] = Position < Count ? Input[Position] : complex();
+			Mix(Plan, Output, Output, Plan.m_Work.data(), false);
+		}
+		return true;
+	}
+	//   Samples below the next power of two M of Count land on multiples
+	//   of N / M in bit-reversed order, the first stages of such a block
+	//   only copy its leading sample over the block
+	unsigned int Length = 1;
+	while (Length < Count)
+		Length <<= 1;
+	const unsigned int Block = N / Length;
+	const unsigned int *const Permutation = &Plan.m_Permutation[0];
+	for (unsigned int Position = 0; Position < Length; ++Position)
+	{
+		const complex Value(Position < Count ? Input[Position] : complex());
+		complex *const Target = Output + Permutation[Position];
+		for (unsigned int Offset = 0; Offset < Block; ++Offset)
+			Target[Offset] = Value;
+	}
+	//   Call FFT implementation for the remaining stages
+	Prune(Plan, Output, N, Block, N, false);
+	//   Succeeded
+	return true;
+}
+
+//   FORWARD FOURIER TRANSFORM OF REAL DATA WITH PLAN, INPUT- AND OUTPUT-PRUNED VERSION
+//     Plan   - precomputed plan, defines length N of real input
+//     Input  - Count leading real input samples, the rest are zeros
+//     Count  - count of non-zero leading samples, 1 to N
+//     Output - N / 2 + 1 entries of working storage, only the first
+//              Bins entries hold the transform result
+//     Bins   - count of low bins needed, N / 2 + 1 for all of them
+template <class T>
+bool TFFT<T>::ForwardRealPadded(const CFFTPlan &Plan, const T *const Input, const unsigned int Count,
+	complex *const Output, const unsigned int Bins)
+{
+	//   No window
+	return Real(Plan, Input, 0, Count, Output, Bins);
+}
+
+//   FORWARD FOURIER TRANSFORM OF WINDOWED REAL DATA WITH PLAN, OUTPUT-PRUNED VERSION
+//     Plan   - precomputed plan, defines length N of real input
+//     Input  - N real input samples
+//     Window - N factors each sample is multiplied by while it is
+//              packed for the transform, no separate pass is made
+//     Output - N / 2 + 1 entries of working storage, only the first
+//              Bins entries hold the transform result
+//     Bins   - count of low bins needed, N / 2 + 1 for all of them
+template <class T>
+bool TFFT<T>::ForwardRealWindowed(const CFFTPlan &Plan, const T *const Input, const T *const Window,
+	complex *const Output, const unsigned int Bins)
+{
+	//   Check input parameters
+	if (!Window)
+		return false;
+	//   Every sample present
+	return Real(Plan, Input, Window, Plan.Size(), Output, Bins);
+}
+
+//   Real transform behind the public versions
+//     Plan   - precomputed plan, defines length N of real input
+//     Input  - Count leading real input samples, the rest are zeros
+//     Window - N factors applied while packing, or null for none
+//     Count  - count of non-zero leading samples, 1 to N
+//     Output - N / 2 + 1 entries of working storage, only the first
+//              Bins entries hold the transform result
+//     Bins   - count of low bins needed, N / 2 + 1 for all of them
+template <class T>
+bool TFFT<T>::Real(const CFFTPlan &Plan, const T *const Input, const T *const Window, const unsigned int Count,
+	complex *const Output, const unsigned int Bins)
+{
+	const unsigned int N = Plan.Size();
+	//   Check input parameters
+	if (!Input || !Output || N < 2 || Count < 1 || Count > N || Bins < 1 || Bins > (N >> 1) + 1)
+		return false;
+	const unsigned int Half = N >> 1;
+	//   Other lengths transform the samples as complex data staged
+	//   at the end of the scratch buffer
+	if (Plan.m_Length != N)
+	{
+		complex *const Staging = &Plan.m_Work[Plan.m_Work.size() - N];
+		if (Window)
+			for (unsigned int Position = 0; Position < Count; ++Position)
+				Staging[Position] = Input[Position] * Window[Position];
+		else
+			for (unsigned int Position = 0; Position < Count; ++Position)
+				Staging[Position] = Input[Position];
+		if (Plan.m_Factors.empty())
+			Chirp(Plan, Staging, Output, Count, Bins, false);
+		else
+		{
+			for (unsigned int Position = Count; Position < N; ++Position)
+				Staging[Position] = 0;
+			Mix(Plan, Staging, Staging, Plan.m_Work.data(), false);
+			for (unsigned int Position = 0; Position < Bins; ++Position)
+				Output[Position] = Staging[Position];
+		}
+		return true;
+	}
+	//   Pack even samples into real and odd samples into imaginary parts
+	//   and transform them at half length
+	const unsigned int Pairs = (Count + 1) >> 1;
+	if (Algorithm == Stockham)
+	{
+		if (Window)
+			//   Whole frame, a contiguous multiply the compiler can vectorize
+			for (unsigned int Position = 0; Position < Half; ++Position)
+				Output[Position] = complex(Input[2 * Position] * Window[2 * Position],
+					Input[2 * Position + 1] * Window[2 * Position + 1]);
+		else
+			for (unsigned int Position = 0; Position < Half; ++Position)
+				Output[Position] = complex(2 * Position < Count ? Input[2 * Position] : T(0),
+					2 * Position + 1 < Count ? Input[2 * Position + 1] : T(0));
+		Autosort(Plan, Output, Output, Half, false);
+	}
+	else
+	{
+		//   Packed samples below the next power of two M of Pairs land on
+		//   multiples of Half / M, their first stages are copies as in
+		//   the complex version; bit reversal of half length drops the
+		//   lowest bit of the full one
+		unsigned int Length = 1;
+		while (Length < Pairs)
+			Length <<= 1;
+		const unsigned int Block = Half / Length;
+		const unsigned int *const Permutation = &Plan.m_Permutation[0];
+		for (unsigned int Position = 0; Position < Length; ++Position)
+		{
+			const T Even = 2 * Position < Count ? Input[2 * Position] : T(0);
+			const T Odd = 2 * Position + 1 < Count ? Input[2 * Position + 1] : T(0);
+			const complex Value(Window ? Even * Window[2 * Position] : Even,
+				Window ? Odd * Window[2 * Position + 1] : Odd);
+			complex *const Target = Output + (Permutation[Position] >> 1);
+			for (unsigned int Offset = 0; Offset < Block; ++Offset)
+				Target[Offset] = Value;
+		}
+		//   Bin k of the result takes bins k and Half - k of the half
+		//   length transform, so both ends of it are kept
+		Prune(Plan, Output, Half, Block, Bins < Half ? Bins : Half, true);
+	}
+	//   Split into spectra of even and odd samples and combine them,
+	//   last stage factors are exactly exp(-2 pi i k / N)
+	const complex *const Twiddles = &Plan.m_Twiddles[Half - 1];
+	const T Re = Output[0].re(), Im = Output[0].im();
+	Output[0] = Re + Im;
+	Output[Half] = Re - Im;
+	const unsigned int Last = Bins - 1 < Half / 2 ? Bins - 1 : Half / 2;
+	for (unsigned int Position = 1; Position <= Last; ++Position)
+	{
+		const complex Left(Output[Position]);
+		const complex Right(Output[Half - Position].conjugate());
+		const complex Even((Left + Right) * T(.5));
+		const complex Odd((Left - Right) * complex(0, T(-.5)));
+		const complex Product(Twiddles[Position] * Odd);
+		Output[Position] = Even + Product;
+		Output[Half - Position] = (Even - Product).conjugate();
+	}
 	//   Succeeded
 	return true;
 }
 
 //   Rearrange function
-void CFFT::Rearrange(const complex *const Input, complex *const Output, const unsigned int N)
+template <class T>
+void TFFT<T>::Rearrange(const complex *const Input, complex *const Output, const unsigned int N)
 {
 	//   Data entry position
 	unsigned int Target = 0;
@@ -106,7 +636,8 @@ void CFFT::Rearrange(const complex *const Input, complex *const Output, const un
 }
 
 //   Inplace version of rearrange function
-void CFFT::Rearrange(complex *const Data, const unsigned int N)
+template <class T>
+void TFFT<T>::Rearrange(complex *const Data, const unsigned int N)
 {
 	//   Swap position
 	unsigned int Target = 0;
@@ -132,8 +663,255 @@ void CFFT::Rearrange(complex *const Data, const unsigned int N)
 	}
 }
 
+//   Planned transform in natural order, Input may equal Output
+template <class T>
+void TFFT<T>::Transform(const CFFTPlan &Plan, const complex *const Input, complex *const Output, const bool Inverse)
+{
+	//   Lengths other than powers of two
+	if (!Plan.m_Factors.empty())
+	{
+		Mix(Plan, Input, Output, Plan.m_Work.data(), Inverse);
+		return;
+	}
+	if (!Plan.m_Chirp.empty())
+	{
+		Chirp(Plan, Input, Output, Plan.Size(), Plan.Size(), Inverse);
+		return;
+	}
+	if (Algorithm == Stockham)
+	{
+		Autosort(Plan, Input, Output, Plan.Size(), Inverse);
+		return;
+	}
+	//   Initialize data
+	if (Input == Output)
+		Rearrange(Plan, Output);
+	else
+		Rearrange(Plan, Input, Output);
+	//   Call FFT implementation
+	Perform(Plan, Output, Plan.Size(), Inverse);
+}
+
+//   Stockham autosort implementation
+template <class T>
+void TFFT<T>::Autosort(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+	const unsigned int N, const bool Inverse)
+{
+	const T *const Source = reinterpret_cast<const T*>(Input);
+	T *const Target = reinterpret_cast<T*>(Output);
+	T *const Work = reinterpret_cast<T*>(Plan.m_Work.data());
+	const T *const Twiddles = reinterpret_cast<const T*>(Plan.m_Twiddles.data());
+#if FFT_SIMD
+	if (Selected == AVX2)
+		PerformStockhamAVX2(Source, Target, Work, N, Twiddles, Inverse);
+	else if (Selected == SSE2)
+		PerformStockhamSSE2(Source, Target, Work, N, Twiddles, Inverse);
+	else
+#endif
+		PerformStockham< ScalarTraits<T> >(Source, Target, Work, N, Twiddles, Inverse);
+}
+
+//   Small DFT of Radix points, Small holds W^k of the radix
+//   already conjugated for inverse transform
+template <unsigned int Radix, class T>
+static inline void Butterfly(tcomplex<T> *const Data, const tcomplex<T> *const Small, const bool Inverse)
+{
+	//   Rotation by -i, or by +i for inverse transform
+	const T Sign = Inverse ? T(-1) : T(1);
+	if (Radix == 2)
+	{
+		const tcomplex<T> Sum(Data[0] + Data[1]);
+		Data[1] = Data[0] - Data[1];
+		Data[0] = Sum;
+	}
+	else if (Radix == 4)
+	{
+		const tcomplex<T> Sum02(Data[0] + Data[2]), Diff02(Data[0] - Data[2]);
+		const tcomplex<T> Sum13(Data[1] + Data[3]), Diff13(Data[1] - Data[3]);
+		const tcomplex<T> Rotated(Sign * Diff13.im(), -Sign * Diff13.re());
+		Data[0] = Sum02 + Sum13;
+		Data[1] = Diff02 + Rotated;
+		Data[2] = Sum02 - Sum13;
+		Data[3] = Diff02 - Rotated;
+	}
+	else if (Radix == 3)
+	{
+		//   sin(2 pi / 3)
+		const T Sine = T(.86602540378443864676);
+		const tcomplex<T> Sum(Data[1] + Data[2]), Diff(Data[1] - Data[2]);
+		const tcomplex<T> Middle(Data[0] - Sum * T(.5));
+		const tcomplex<T> Rotated(Sign * Sine * Diff.im(), -Sign * Sine * Diff.re());
+		Data[0] += Sum;
+		Data[1] = Middle + Rotated;
+		Data[2] = Middle - Rotated;
+	}
+	else
+	{
+		//   Radices 5 and 7 pair points k and Radix - k, their sum takes
+		//   the real part of the root and their difference the imaginary one
+		tcomplex<T> Sums[3], Diffs[3];
+		const unsigned int Pairs = Radix >> 1;
+		tcomplex<T> Total(Data[0]);
+		for (unsigned int Pair = 1; Pair <= Pairs; ++Pair)
+		{
+			Sums[Pair - 1] = Data[Pair] + Data[Radix - Pair];
+			Diffs[Pair - 1] = Data[Pair] - Data[Radix - Pair];
+			Total += Sums[Pair - 1];
+		}
+		for (unsigned int Bin = 1; Bin <= Pairs; ++Bin)
+		{
+			tcomplex<T> Real(Data[0]), Imaginary;
+			unsigned int Power = 0;
+			for (unsigned int Pair = 0; Pair < Pairs; ++Pair)
+			{
+				if ((Power += Bin) >= Radix)
+					Power -= Radix;
+				Real += Sums[Pair] * Small[Power].re();
+				Imaginary += Diffs[Pair] * Small[Power].im();
+			}
+			//   i * Imaginary
+			const tcomplex<T> Rotated(-Imaginary.im(), Imaginary.re());
+			Data[Bin] = Real + Rotated;
+			Data[Radix - Bin] = Real - Rotated;
+		}
+		Data[0] = Total;
+	}
+}
+
+//   One mixed-radix stage, Span is the length of transforms
+//   already combined
+template <unsigned int Radix, class T>
+static void MixStage(const tcomplex<T> *const Source, tcomplex<T> *const Target, const unsigned int N,
+	const unsigned int Span, const tcomplex<T> *const Roots, const bool Inverse)
+{
+	//   Distance between points of one butterfly
+	const unsigned int Count = N / Radix;
+	//   Root step of the stage, W of length Span * Radix
+	const unsigned int Stride = N / (Span * Radix);
+	//   Roots of the radix itself
+	tcomplex<T> Small[Radix];
+	for (unsigned int Power = 0; Power < Radix; ++Power)
+		Small[Power] = Inverse ? Roots[Power * Count].conjugate() : Roots[Power * Count];
+	tcomplex<T> Factors[Radix], Points[Radix];
+	for (unsigned int Offset = 0; Offset < Span; ++Offset)
+	{
+		//   Factors are shared by every group of the same offset
+		for (unsigned int Point = 1; Point < Radix; ++Point)
+			Factors[Point] = Inverse ? Roots[Offset * Point * Stride].conjugate() : Roots[Offset * Point * Stride];
+		for (unsigned int Group = 0; Group < Count; Group += Span)
+		{
+			//   Gather and twist
+			const tcomplex<T> *const Sample = Source + Group + Offset;
+			Points[0] = Sample[0];
+			for (unsigned int Point = 1; Point < Radix; ++Point)
+				Points[Point] = Sample[Point * Count] * Factors[Point];
+			Butterfly<Radix>(Points, Small, Inverse);
+			//   Scatter in natural order
+			tcomplex<T> *const Block = Target + Group * Radix + Offset;
+			for (unsigned int Point = 0; Point < Radix; ++Point)
+				Block[Point * Span] = Points[Point];
+		}
+	}
+}
+
+//   Mixed-radix Stockham implementation
+template <class T>
+void TFFT<T>::Mix(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+	complex *const Work, const bool Inverse)
+{
+	const unsigned int N = Plan.m_N;
+	const unsigned int Stages = (unsigned int)Plan.m_Factors.size();
+	const complex *const Roots = Plan.m_Roots.data();
+	//   Stages alternate between Output and Work and the last one must
+	//   write Output, odd stage count starts from a copy when inplace
+	const complex *Source = Input;
+	complex *Target = Stages & 1 ? Output : Work;
+	if (Stages & 1 && Input == Output)
+	{
+		for (unsigned int Position = 0; Position < N; ++Position)
+			Work[Position] = Input[Position];
+		Source = Work;
+	}
+	//   Length of transforms already combined
+	unsigned int Span = 1;
+	for (unsigned int Stage = 0; Stage < Stages; ++Stage)
+	{
+		const unsigned int Radix = Plan.m_Factors[Stage];
+		switch (Radix)
+		{
+		case 2: MixStage<2>(Source, Target, N, Span, Roots, Inverse); break;
+		case 3: MixStage<3>(Source, Target, N, Span, Roots, Inverse); break;
+		case 4: MixStage<4>(Source, Target, N, Span, Roots, Inverse); break;
+		case 5: MixStage<5>(Source, Target, N, Span, Roots, Inverse); break;
+		default: MixStage<7>(Source, Target, N, Span, Roots, Inverse); break;
+		}
+		Span *= Radix;
+		Source = Target;
+		Target = Target == Output ? Work : Output;
+	}
+}
+
+//   Bluestein implementation
+template <class T>
+void TFFT<T>::Chirp(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+	const unsigned int Samples, const unsigned int Bins, const bool Inverse)
+{
+	const unsigned int Length = Plan.m_Length;
+	const complex *const Chirp = Plan.m_Chirp.data();
+	const complex *const Kernel = Plan.m_Kernel.data();
+	complex *const Work = Plan.m_Work.data();
+	//   Inverse transform is the conjugate of the forward transform
+	//   of conjugate data
+	for (unsigned int Position = 0; Position < Samples; ++Position)
+		Work[Position] = (Inverse ? Input[Position].conjugate() : Input[Position]) * Chirp[Position];
+	for (unsigned int Position = Samples; Position < Length; ++Position)
+		Work[Position] = 0;
+	//   Circular convolution with the filter, its scaling is in the kernel;
+	//   Stockham would need a second scratch buffer, so in-place engines run
+	Rearrange(Plan, Work);
+	Perform(Plan, Work, Length);
+	for (unsigned int Position = 0; Position < Length; ++Position)
+		Work[Position] *= Kernel[Position];
+	//   Only the first Bins outputs of the inverse transform are used
+	Rearrange(Plan, Work);
+	Prune(Plan, Work, Length, 1, Bins, false, true);
+	for (unsigned int Position = 0; Position < Bins; ++Position)
+	{
+		const complex Result(Work[Position] * Chirp[Position]);
+		Output[Position] = Inverse ? Result.conjugate() : Result;
+	}
+}
+
+//   Rearrange by precomputed permutation
+template <class T>
+void TFFT<T>::Rearrange(const CFFTPlan &Plan, const complex *const Input, complex *const Output)
+{
+	const unsigned int *const Permutation = &Plan.m_Permutation[0];
+	for (unsigned int Position = 0; Position < Plan.m_Length; ++Position)
+		Output[Permutation[Position]] = Input[Position];
+}
+
+//   Inplace version of rearrange by precomputed permutation
+template <class T>
+void TFFT<T>::Rearrange(const CFFTPlan &Plan, complex *const Data)
+{
+	const unsigned int *const Permutation = &Plan.m_Permutation[0];
+	for (unsigned int Position = 0; Position < Plan.m_Length; ++Position)
+	{
+		const unsigned int Target = Permutation[Position];
+		//   Only for not yet swapped entries
+		if (Target > Position)
+		{
+			const complex Temp(Data[Target]);
+			Data[Target] = Data[Position];
+			Data[Position] = Temp;
+		}
+	}
+}
+
 //   FFT implementation
-void CFFT::Perform(complex *const Data, const unsigned int N, const bool Inverse /* = false */)
+template <class T>
+void TFFT<T>::Perform(complex *const Data, const unsigned int N, const bool Inverse /* = false */)
 {
 	const double pi = Inverse ? 3.14159265358979323846 : -3.14159265358979323846;
 	//   Iteration through dyads, quadruples, octads and so on...
@@ -146,9 +924,9 @@ void CFFT::Perform(complex *const Data, const unsigned int N, const bool Inverse
 		//   Auxiliary sin(delta / 2)
 		const double Sine = sin(delta * .5);
 		//   Multiplier for trigonometric recurrence
-		const complex Multiplier(-2. * Sine * Sine, sin(delta));
+		const complex Multiplier(T(-2. * Sine * Sine), T(sin(delta)));
 		//   Start value for transform factor, fi = 0
-		complex Factor(1.);
+		complex Factor(1);
 		//   Iteration through groups of different transform factor
 		for (unsigned int Group = 0; Group < Step; ++Group)
 		{
@@ -170,11 +948,107 @@ void CFFT::Perform(complex *const Data, const unsigned int N, const bool Inverse
 	}
 }
 
+//   FFT implementation with precomputed transform factors
+template <class T>
+void TFFT<T>::Perform(const CFFTPlan &Plan, complex *const Data, const unsigned int N, const bool Inverse /* = false */)
+{
+	T *const Values = reinterpret_cast<T*>(Data);
+	const T *const Twiddles = reinterpret_cast<const T*>(Plan.m_Twiddles.data());
+	//   Radix-4 engine
+	if (Algorithm == Radix4)
+	{
+		const T *const Triples = reinterpret_cast<const T*>(Plan.m_Triples.data());
+#if FFT_SIMD
+		if (Selected == AVX2)
+			PerformRadix4AVX2(Values, N, Twiddles, Triples, Inverse);
+		else if (Selected == SSE2)
+			PerformRadix4SSE2(Values, N, Twiddles, Triples, Inverse);
+		else
+#endif
+			PerformRadix4< ScalarTraits<T> >(Values, N, Twiddles, Triples, Inverse);
+		return;
+	}
+#if FFT_SIMD
+	//   Vectorized radix-2 kernels if enabled
+	if (Selected != Scalar)
+	{
+		if (Selected == AVX2)
+			PerformAVX2(Values, N, Twiddles, Inverse);
+		else
+			PerformSSE2(Values, N, Twiddles, Inverse);
+		return;
+	}
+#endif
+	//   Iteration through dyads, quadruples, octads and so on...
+	for (unsigned int Step = 1; Step < N; Step <<= 1)
+	{
+		//   Jump to the next entry of the same transform factor
+		const unsigned int Jump = Step << 1;
+		//   Transform factors of this stage
+		const complex *const Twiddles = &Plan.m_Twiddles[Step - 1];
+		//   Iteration through groups of different transform factor
+		for (unsigned int Group = 0; Group < Step; ++Group)
+		{
+			//   Inverse transform uses conjugate factors
+			const complex Factor = Inverse ? Twiddles[Group].conjugate() : Twiddles[Group];
+			//   Iteration within group 
+			for (unsigned int Pair = Group; Pair < N; Pair += Jump)
+			{
+				//   Match position
+				const unsigned int Match = Pair + Step;
+				//   Second term of two-point transform
+				const complex Product(Factor * Data[Match]);
+				//   Transform for fi + pi
+				Data[Match] = Data[Pair] - Product;
+				//   Transform for fi
+				Data[Pair] += Product;
+			}
+		}
+	}
+}
+
+//   Output-pruned FFT implementation
+template <class T>
+void TFFT<T>::Prune(const CFFTPlan &Plan, complex *const Data, const unsigned int N, const unsigned int Start,
+	const unsigned int Bins, const bool Mirror, const bool Inverse /* = false */)
+{
+	//   Stage of half-length Step needs every group while Bins reach
+	//   past it, early stages are independent transforms of length
+	//   Block and run on the full engines
+	unsigned int Block = Start;
+	if (Start == 1)
+	{
+		while (Block < N && (Mirror ? Block < 2 * Bins : Block <= Bins))
+			Block <<= 1;
+		if (Block > 1)
+			for (unsigned int Offset = 0; Offset < N; Offset += Block)
+				Perform(Plan, Data + Offset, Block, Inverse);
+	}
+	//   Remaining stages skip groups whose both outputs are unused
+	T *const Values = reinterpret_cast<T*>(Data);
+	const T *const Twiddles = reinterpret_cast<const T*>(Plan.m_Twiddles.data());
+#if FFT_SIMD
+	if (Selected == AVX2)
+		PerformPrunedAVX2(Values, N, Block, Bins, Mirror, Twiddles, Inverse);
+	else if (Selected == SSE2)
+		PerformPrunedSSE2(Values, N, Block, Bins, Mirror, Twiddles, Inverse);
+	else
+#endif
+		PerformPruned< ScalarTraits<T> >(Values, N, Block, Bins, Mirror, Twiddles, Inverse);
+}
+
 //   Scaling of inverse FFT result
-void CFFT::Scale(complex *const Data, const unsigned int N)
+template <class T>
+void TFFT<T>::Scale(complex *const Data, const unsigned int N)
 {
-	const double Factor = 1. / double(N);
+	const T Factor = T(1. / double(N));
 	//   Scale all data entries
 	for (unsigned int Position = 0; Position < N; ++Position)
 		Data[Position] *= Factor;
 }
+
+//   Double and single precision instantiations
+template class TFFTPlan<double>;
+template class TFFTPlan<float>;
+template class TFFT<double>;
+template class TFFT<float>;
@@ -1,4 +1,4 @@
-//   fft.h - declaration of class
+//   fft.h - declaration of class templates
 //   of fast Fourier transform - FFT
 //
 //   The code is property of LIBROW
@@ -10,10 +10,105 @@
 
 //   Include complex numbers header
 #include "complex.h"
+//   Include vector header
+#include <vector>
 
-class CFFT
+template <class T> class TFFT;
+
+//   FFT PLAN - tables precomputed once for the given length
+//   and reused by every transform of that length
+template <class T>
+class TFFTPlan
 {
 public:
+	//   Constructors
+	TFFTPlan(): m_N(0), m_Length(0) {}
+	explicit TFFTPlan(const unsigned int N): m_N(0), m_Length(0) { Create(N); }
+
+	//   PLAN CREATION
+	//     N - transform length, powers of two run radix-2/4 engines,
+	//         products of 2, 3, 5 and 7 the mixed-radix engine
+	//         and any other length Bluestein's algorithm
+	bool Create(const unsigned int N);
+
+	//   Transform length, 0 if plan is not created
+	unsigned int Size() const { return m_N; }
+
+protected:
+	//   Transform length
+	unsigned int m_N;
+	//   Power-of-two length of the tables below, the transform length
+	//   or the convolution length of Bluestein plans, 0 for mixed radix
+	unsigned int m_Length;
+	//   Bit-reversed position of every entry
+	std::vector<unsigned int> m_Permutation;
+	//   Transform factors of every stage, stage of half-length Step
+	//   occupies entries [Step - 1, 2 * Step - 1)
+	std::vector< tcomplex<T> > m_Twiddles;
+	//   Factors W^3g of radix-4 stages, stage of quarter-length Quarter
+	//   occupies entries [Quarter - 1, 2 * Quarter - 1)
+	std::vector< tcomplex<T> > m_Triples;
+	//   Radices of mixed-radix plans, empty for other plans
+	std::vector<unsigned int> m_Factors;
+	//   Roots exp(-2 pi i k / N) of mixed-radix plans
+	std::vector< tcomplex<T> > m_Roots;
+	//   Chirp exp(-pi i n^2 / N) of Bluestein plans
+	std::vector< tcomplex<T> > m_Chirp;
+	//   Spectrum of the conjugate chirp scaled by 1 / m_Length
+	std::vector< tcomplex<T> > m_Kernel;
+	//   Scratch buffer of Stockham, mixed-radix and Bluestein engines,
+	//   so a plan must not be used by two threads at once
+	mutable std::vector< tcomplex<T> > m_Work;
+
+	friend class TFFT<T>;
+};
+
+//   Settings shared by transforms of every precision
+class CFFTBase
+{
+public:
+	//   Instruction sets of butterfly kernels
+	enum Instructions
+	{
+		Scalar,
+		SSE2,
+		AVX2
+	};
+
+	//   INSTRUCTION SET SELECTION
+	//     Set - preferred instruction set, falls back to the best
+	//           one supported by the CPU, Scalar forces the scalar path
+	//   Should be called before transforms run on other threads
+	static void SetInstructions(const Instructions Set);
+
+	//   Instruction set in use, detected by CPUID at startup
+	static Instructions GetInstructions();
+
+	//   Butterfly engines of planned transforms
+	enum Algorithms
+	{
+		Radix2,
+		Radix4,
+		Stockham
+	};
+
+	//   ENGINE SELECTION
+	//     Algorithm - engine used by planned transforms
+	//   Should be called before transforms run on other threads
+	static void SetAlgorithm(const Algorithms Algorithm);
+
+	//   Engine in use, radix-4 by default
+	static Algorithms GetAlgorithm();
+};
+
+//   FFT of scalar type T, float or double
+template <class T>
+class TFFT : public CFFTBase
+{
+public:
+	typedef tcomplex<T> complex;
+	typedef TFFTPlan<T> CFFTPlan;
+
 	//   FORWARD FOURIER TRANSFORM
 	//     Input  - input data
 	//     Output - transform result
@@ -38,16 +133,147 @@ public:
 	//     Scale - if to scale result
 	static bool Inverse(complex *const Data, const unsigned int N, const bool Scale = true);
 
+	//   FORWARD FOURIER TRANSFORM WITH PLAN
+	//     Plan   - precomputed plan, defines length
+	//     Input  - input data
+	//     Output - transform result
+	static bool Forward(const CFFTPlan &Plan, const complex *const Input, complex *const Output);
+
+	//   FORWARD FOURIER TRANSFORM WITH PLAN, INPLACE VERSION
+	//     Plan - precomputed plan, defines length
+	//     Data - both input data and output
+	static bool Forward(const CFFTPlan &Plan, complex *const Data);
+
+	//   INVERSE FOURIER TRANSFORM WITH PLAN
+	//     Plan   - precomputed plan, defines length
+	//     Input  - input data
+	//     Output - transform result
+	//     Scale  - if to scale result
+	static bool Inverse(const CFFTPlan &Plan, const complex *const Input, complex *const Output, const bool Scale = true);
+
+	//   INVERSE FOURIER TRANSFORM WITH PLAN, INPLACE VERSION
+	//     Plan  - precomputed plan, defines length
+	//     Data  - both input data and output
+	//     Scale - if to scale result
+	static bool Inverse(const CFFTPlan &Plan, complex *const Data, const bool Scale = true);
+
+	//   FORWARD FOURIER TRANSFORM OF REAL DATA WITH PLAN
+	//     Plan   - precomputed plan, defines length N of real input,
+	//              lengths other than powers of two run a complex transform
+	//     Input  - N real input samples
+	//     Output - N / 2 + 1 non-redundant bins of the result
+	static bool ForwardReal(const CFFTPlan &Plan, const T *const Input, complex *const Output);
+
+	//   FORWARD FOURIER TRANSFORM WITH PLAN, OUTPUT-PRUNED VERSION
+	//     Plan   - precomputed plan, defines length N
+	//     Input  - input data
+	//     Output - N entries of working storage, only the first Bins
+	//              entries hold the transform result
+	//     Bins   - count of low bins needed, butterflies feeding
+	//              only higher bins are skipped
+	static bool ForwardPruned(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+		const unsigned int Bins);
+
+	//   FORWARD FOURIER TRANSFORM OF REAL DATA WITH PLAN, OUTPUT-PRUNED VERSION
+	//     Plan   - precomputed plan, defines length N of real input
+	//     Input  - N real input samples
+	//     Output - N / 2 + 1 entries of working storage, only the first
+	//              Bins entries hold the transform result
+	//     Bins   - count of low bins needed, at most N / 2 + 1
+	static bool ForwardRealPruned(const CFFTPlan &Plan, const T *const Input, complex *const Output,
+		const unsigned int Bins);
+
+	//   FORWARD FOURIER TRANSFORM WITH PLAN, INPUT-PRUNED VERSION
+	//     Plan   - precomputed plan, defines length N
+	//     Input  - Count leading input samples, the rest are zeros,
+	//              must not overlap Output
+	//     Count  - count of non-zero leading samples, 1 to N
+	//     Output - transform result, N entries
+	static bool ForwardPadded(const CFFTPlan &Plan, const complex *const Input, const unsigned int Count,
+		complex *const Output);
+
+	//   FORWARD FOURIER TRANSFORM OF REAL DATA WITH PLAN, INPUT- AND OUTPUT-PRUNED VERSION
+	//     Plan   - precomputed plan, defines length N of real input
+	//     Input  - Count leading real input samples, the rest are zeros
+	//     Count  - count of non-zero leading samples, 1 to N
+	//     Output - N / 2 + 1 entries of working storage, only the first
+	//              Bins entries hold the transform result
+	//     Bins   - count of low bins needed, N / 2 + 1 for all of them
+	static bool ForwardRealPadded(const CFFTPlan &Plan, const T *const Input, const unsigned int Count,
+		complex *const Output, const unsigned int Bins);
+
+	//   FORWARD FOURIER TRANSFORM OF WINDOWED REAL DATA WITH PLAN, OUTPUT-PRUNED VERSION
+	//     Plan   - precomputed plan, defines length N of real input
+	//     Input  - N real input samples
+	//     Window - N factors each sample is multiplied by while it is
+	//              packed for the transform, no separate pass is made
+	//     Output - N / 2 + 1 entries of working storage, only the first
+	//              Bins entries hold the transform result
+	//     Bins   - count of low bins needed, N / 2 + 1 for all of them
+	static bool ForwardRealWindowed(const CFFTPlan &Plan, const T *const Input, const T *const Window,
+		complex *const Output, const unsigned int Bins);
+
 protected:
+	//   Real transform behind the public versions, Window may be null
+	static bool Real(const CFFTPlan &Plan, const T *const Input, const T *const Window, const unsigned int Count,
+		complex *const Output, const unsigned int Bins);
+
 	//   Rearrange function and its inplace version
 	static void Rearrange(const complex *const Input, complex *const Output, const unsigned int N);
 	static void Rearrange(complex *const Data, const unsigned int N);
 
+	//   Planned transform in natural order, Input may equal Output
+	static void Transform(const CFFTPlan &Plan, const complex *const Input, complex *const Output, const bool Inverse);
+
+	//   Stockham autosort implementation, no rearrange needed,
+	//   N may be any power of two up to the plan length
+	static void Autosort(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+		const unsigned int N, const bool Inverse);
+
+	//   Mixed-radix Stockham implementation for lengths of factors 2, 3, 5
+	//   and 7, Input may equal Output, Work holds N entries
+	static void Mix(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+		complex *const Work, const bool Inverse);
+
+	//   Bluestein implementation for any other length, Input may equal
+	//   Output and holds Samples leading entries followed by zeros,
+	//   only the first Bins bins are stored
+	static void Chirp(const CFFTPlan &Plan, const complex *const Input, complex *const Output,
+		const unsigned int Samples, const unsigned int Bins, const bool Inverse);
+
+	//   Rearrange by precomputed permutation and its inplace version
+	static void Rearrange(const CFFTPlan &Plan, const complex *const Input, complex *const Output);
+	static void Rearrange(const CFFTPlan &Plan, complex *const Data);
+
 	//   FFT implementation
 	static void Perform(complex *const Data, const unsigned int N, const bool Inverse = false);
 
+	//   FFT implementation with precomputed transform factors,
+	//   N may be any power of two up to the plan length
+	static void Perform(const CFFTPlan &Plan, complex *const Data, const unsigned int N, const bool Inverse = false);
+
+	//   Pruned FFT implementation on rearranged data, N may be any
+	//   power of two up to the plan length; transforms of length Start
+	//   are already done on every block, 1 if none, and only bins below
+	//   Bins and, if Mirror is set, above N - Bins are computed
+	static void Prune(const CFFTPlan &Plan, complex *const Data, const unsigned int N, const unsigned int Start,
+		const unsigned int Bins, const bool Mirror, const bool Inverse = false);
+
 	//   Scaling of inverse FFT result
 	static void Scale(complex *const Data, const unsigned int N);
 };
 
+//   Double precision for offline measurement work,
+//   single precision for the capture path
+typedef TFFTPlan<double> CFFTPlan;
+typedef TFFT<double> CFFT;
+typedef TFFTPlan<float> CFFTPlanF;
+typedef TFFT<float> CFFTF;
+
+//   Both precisions are compiled once in fft.cpp
+extern template class TFFTPlan<double>;
+extern template class TFFTPlan<float>;
+extern template class TFFT<double>;
+extern template class TFFT<float>;
+
 #endif
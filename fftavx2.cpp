@@ -0,0 +1,147 @@
+//   fftavx2.cpp - AVX2 and FMA butterfly kernels, two double
+//   or four single precision complex numbers per register
+//
+//   Called only after the CPU has been checked for support
+
+//   Allow AVX2 and FMA intrinsics in this translation unit only
+#if defined(__GNUC__) && !defined(__AVX2__)
+#pragma GCC target("avx2,fma")
+#endif
+
+//   Include declaration file
+#include "fftkernels.h"
+
+#if FFT_SIMD
+
+//   Include AVX intrinsics
+#include <immintrin.h>
+//   Include generic kernels
+#include "fftsimd.h"
+
+namespace
+{
+	//   Two double precision complex numbers per register
+	struct AVX2Traits
+	{
+		typedef double Real;
+		enum { Width = 2 };
+		typedef __m256d Vector;
+		typedef SSE2Traits Narrow;
+		typedef SSE2Traits Single;
+
+		static Vector Load(const double *const Source) { return _mm256_loadu_pd(Source); }
+		static Vector Splat(const double *const Source) { return _mm256_broadcast_pd(reinterpret_cast<const __m128d*>(Source)); }
+		static void Store(double *const Target, const Vector Value) { _mm256_storeu_pd(Target, Value); }
+		static Vector Add(const Vector Left, const Vector Right) { return _mm256_add_pd(Left, Right); }
+		static Vector Sub(const Vector Left, const Vector Right) { return _mm256_sub_pd(Left, Right); }
+
+		static Vector Mul(const Vector Left, const Vector Right)
+		{
+			//   (a + bi)(c + di) = (ac - bd) + (bc + ad)i
+			const Vector Re = _mm256_movedup_pd(Right);
+			const Vector Im = _mm256_permute_pd(Right, 0xF);
+			const Vector Swapped = _mm256_permute_pd(Left, 0x5);
+			return _mm256_fmaddsub_pd(Left, Re, _mm256_mul_pd(Swapped, Im));
+		}
+
+		static Vector MulNegI(const Vector Value)
+		{
+			//   (a + bi)(-i) = b - ai
+			return _mm256_xor_pd(_mm256_permute_pd(Value, 0x5), _mm256_set_pd(-0., 0., -0., 0.));
+		}
+
+		static Vector Conjugate(const Vector Value) { return _mm256_xor_pd(Value, _mm256_set_pd(-0., 0., -0., 0.)); }
+	};
+
+	//   Four single precision complex numbers per register
+	struct AVX2FloatTraits
+	{
+		typedef float Real;
+		enum { Width = 4 };
+		typedef __m256 Vector;
+		typedef SSE2FloatTraits Narrow;
+		typedef ScalarTraits<float> Single;
+
+		static Vector Load(const float *const Source) { return _mm256_loadu_ps(Source); }
+		static Vector Splat(const float *const Source)
+		{
+			return _mm256_castpd_ps(_mm256_broadcast_sd(reinterpret_cast<const double*>(Source)));
+		}
+		static void Store(float *const Target, const Vector Value) { _mm256_storeu_ps(Target, Value); }
+		static Vector Add(const Vector Left, const Vector Right) { return _mm256_add_ps(Left, Right); }
+		static Vector Sub(const Vector Left, const Vector Right) { return _mm256_sub_ps(Left, Right); }
+
+		static Vector Mul(const Vector Left, const Vector Right)
+		{
+			//   (a + bi)(c + di) = (ac - bd) + (bc + ad)i
+			const Vector Re = _mm256_moveldup_ps(Right);
+			const Vector Im = _mm256_movehdup_ps(Right);
+			const Vector Swapped = _mm256_permute_ps(Left, _MM_SHUFFLE(2, 3, 0, 1));
+			return _mm256_fmaddsub_ps(Left, Re, _mm256_mul_ps(Swapped, Im));
+		}
+
+		static Vector MulNegI(const Vector Value)
+		{
+			//   (a + bi)(-i) = b - ai
+			return _mm256_xor_ps(_mm256_permute_ps(Value, _MM_SHUFFLE(2, 3, 0, 1)),
+				_mm256_set_ps(-0.f, 0.f, -0.f, 0.f, -0.f, 0.f, -0.f, 0.f));
+		}
+
+		static Vector Conjugate(const Vector Value)
+		{
+			return _mm256_xor_ps(Value, _mm256_set_ps(-0.f, 0.f, -0.f, 0.f, -0.f, 0.f, -0.f, 0.f));
+		}
+	};
+}
+
+//   RADIX-2 BUTTERFLIES OVER BIT-REVERSED DATA
+void PerformAVX2(double *const Data, const unsigned int N, const double *const Twiddles, const bool Inverse)
+{
+	PerformRadix2<AVX2Traits>(Data, N, Twiddles, Inverse);
+}
+
+void PerformAVX2(float *const Data, const unsigned int N, const float *const Twiddles, const bool Inverse)
+{
+	PerformRadix2<AVX2FloatTraits>(Data, N, Twiddles, Inverse);
+}
+
+//   OUTPUT-PRUNED RADIX-2 STAGES OVER BIT-REVERSED DATA
+void PerformPrunedAVX2(double *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const double *const Twiddles, const bool Inverse)
+{
+	PerformPruned<AVX2Traits>(Data, N, Step, Bins, Mirror, Twiddles, Inverse);
+}
+
+void PerformPrunedAVX2(float *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const float *const Twiddles, const bool Inverse)
+{
+	PerformPruned<AVX2FloatTraits>(Data, N, Step, Bins, Mirror, Twiddles, Inverse);
+}
+
+//   RADIX-4 BUTTERFLIES OVER BIT-REVERSED DATA
+void PerformRadix4AVX2(double *const Data, const unsigned int N, const double *const Twiddles,
+	const double *const Triples, const bool Inverse)
+{
+	PerformRadix4<AVX2Traits>(Data, N, Twiddles, Triples, Inverse);
+}
+
+void PerformRadix4AVX2(float *const Data, const unsigned int N, const float *const Twiddles,
+	const float *const Triples, const bool Inverse)
+{
+	PerformRadix4<AVX2FloatTraits>(Data, N, Twiddles, Triples, Inverse);
+}
+
+//   STOCKHAM AUTOSORT TRANSFORM
+void PerformStockhamAVX2(const double *const Input, double *const Output, double *const Work,
+	const unsigned int N, const double *const Twiddles, const bool Inverse)
+{
+	PerformStockham<AVX2Traits>(Input, Output, Work, N, Twiddles, Inverse);
+}
+
+void PerformStockhamAVX2(const float *const Input, float *const Output, float *const Work,
+	const unsigned int N, const float *const Twiddles, const bool Inverse)
+{
+	PerformStockham<AVX2FloatTraits>(Input, Output, Work, N, Twiddles, Inverse);
+}
+
+#endif
@@ -0,0 +1,81 @@
+//   fftkernels.h - declaration of vectorized
+//   butterfly kernels of fast Fourier transform
+//
+//   Kernels operate on complex data viewed as interleaved
+//   real and imaginary parts and on transform factor tables
+//   laid out as in TFFTPlan, in double and single precision
+
+#ifndef _FFTKERNELS_H_
+#define _FFTKERNELS_H_
+
+//   Kernels exist only for x86 and x64 targets
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define FFT_SIMD 1
+#else
+#define FFT_SIMD 0
+#endif
+
+#if FFT_SIMD
+
+//   RADIX-2 BUTTERFLIES OVER BIT-REVERSED DATA
+//     Data     - both input data and output
+//     N        - length of data, power of two
+//     Twiddles - transform factors of all stages
+//     Inverse  - if to use conjugate factors
+void PerformSSE2(double *const Data, const unsigned int N, const double *const Twiddles, const bool Inverse);
+void PerformAVX2(double *const Data, const unsigned int N, const double *const Twiddles, const bool Inverse);
+void PerformSSE2(float *const Data, const unsigned int N, const float *const Twiddles, const bool Inverse);
+void PerformAVX2(float *const Data, const unsigned int N, const float *const Twiddles, const bool Inverse);
+
+//   OUTPUT-PRUNED RADIX-2 STAGES OVER BIT-REVERSED DATA
+//     Data     - both input data and output, transforms of length
+//                Step already done on every block
+//     N        - length of data, power of two
+//     Step     - half-length of the first remaining stage
+//     Bins     - count of low bins kept, N keeps every bin
+//     Mirror   - if to keep high bins above N - Bins too
+//     Twiddles - transform factors of all stages
+//     Inverse  - if to use conjugate factors
+void PerformPrunedSSE2(double *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const double *const Twiddles, const bool Inverse);
+void PerformPrunedAVX2(double *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const double *const Twiddles, const bool Inverse);
+void PerformPrunedSSE2(float *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const float *const Twiddles, const bool Inverse);
+void PerformPrunedAVX2(float *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const float *const Twiddles, const bool Inverse);
+
+//   RADIX-4 BUTTERFLIES OVER BIT-REVERSED DATA
+//     Data     - both input data and output
+//     N        - length of data, power of two
+//     Twiddles - transform factors of all radix-2 stages
+//     Triples  - factors W^3g of all radix-4 stages
+//     Inverse  - if to use conjugate factors
+void PerformRadix4SSE2(double *const Data, const unsigned int N, const double *const Twiddles,
+	const double *const Triples, const bool Inverse);
+void PerformRadix4AVX2(double *const Data, const unsigned int N, const double *const Twiddles,
+	const double *const Triples, const bool Inverse);
+void PerformRadix4SSE2(float *const Data, const unsigned int N, const float *const Twiddles,
+	const float *const Triples, const bool Inverse);
+void PerformRadix4AVX2(float *const Data, const unsigned int N, const float *const Twiddles,
+	const float *const Triples, const bool Inverse);
+
+//   STOCKHAM AUTOSORT TRANSFORM, NATURAL ORDER IN AND OUT
+//     Input    - input data, may be the same as output
+//     Output   - transform result
+//     Work     - scratch buffer of N complex numbers
+//     N        - length of data, power of two
+//     Twiddles - transform factors of all radix-2 stages
+//     Inverse  - if to use conjugate factors
+void PerformStockhamSSE2(const double *const Input, double *const Output, double *const Work,
+	const unsigned int N, const double *const Twiddles, const bool Inverse);
+void PerformStockhamAVX2(const double *const Input, double *const Output, double *const Work,
+	const unsigned int N, const double *const Twiddles, const bool Inverse);
+void PerformStockhamSSE2(const float *const Input, float *const Output, float *const Work,
+	const unsigned int N, const float *const Twiddles, const bool Inverse);
+void PerformStockhamAVX2(const float *const Input, float *const Output, float *const Work,
+	const unsigned int N, const float *const Twiddles, const bool Inverse);
+
+#endif
+
+#endif
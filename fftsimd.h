@@ -0,0 +1,460 @@
+//   fftsimd.h - butterfly kernels written once over
+//   a vector traits class and instantiated per instruction set
+//
+//   Traits class V provides
+//     V::Real      - scalar type, float or double
+//     V::Width     - complex numbers held by one register
+//     V::Vector    - register type
+//     V::Narrow    - next narrower traits, used where a stage
+//                    is narrower than the register
+//     V::Single    - traits of width one
+//     V::Load      - unaligned load of Width complex numbers
+//     V::Splat     - one complex number loaded into every lane
+//     V::Store     - unaligned store of Width complex numbers
+//     V::Add       - sum
+//     V::Sub       - difference
+//     V::Mul       - complex product
+//     V::MulNegI   - product with -i
+//     V::Conjugate - conjugate of every complex number
+//
+//   Included only by kernel translation units, each compiled
+//   for its own instruction set, and by fft.cpp for the scalar path
+
+#ifndef _FFTSIMD_H_
+#define _FFTSIMD_H_
+
+#include "fftkernels.h"
+
+#if FFT_SIMD
+//   Include SSE2 intrinsics
+#include <emmintrin.h>
+#endif
+
+//   Unnamed namespace keeps every instantiation local to the
+//   translation unit, so no code built for a wider instruction
+//   set can be picked by the linker for a narrower one
+namespace
+{
+	//   Plain scalar traits
+	template <class T>
+	struct ScalarTraits
+	{
+		typedef T Real;
+		enum { Width = 1 };
+		struct Vector { T Re, Im; };
+		typedef ScalarTraits Narrow;
+		typedef ScalarTraits Single;
+
+		static Vector Make(const T Re, const T Im) { Vector Result = { Re, Im }; return Result; }
+		static Vector Load(const T *const Source) { return Make(Source[0], Source[1]); }
+		static Vector Splat(const T *const Source) { return Load(Source); }
+		static void Store(T *const Target, const Vector Value) { Target[0] = Value.Re; Target[1] = Value.Im; }
+		static Vector Add(const Vector Left, const Vector Right) { return Make(Left.Re + Right.Re, Left.Im + Right.Im); }
+		static Vector Sub(const Vector Left, const Vector Right) { return Make(Left.Re - Right.Re, Left.Im - Right.Im); }
+		static Vector Mul(const Vector Left, const Vector Right)
+		{
+			return Make(Left.Re * Right.Re - Left.Im * Right.Im, Left.Re * Right.Im + Left.Im * Right.Re);
+		}
+		static Vector MulNegI(const Vector Value) { return Make(Value.Im, -Value.Re); }
+		static Vector Conjugate(const Vector Value) { return Make(Value.Re, -Value.Im); }
+	};
+
+#if FFT_SIMD
+	//   SSE2 traits, one double precision complex number per register
+	struct SSE2Traits
+	{
+		typedef double Real;
+		enum { Width = 1 };
+		typedef __m128d Vector;
+		typedef SSE2Traits Narrow;
+		typedef SSE2Traits Single;
+
+		static Vector Load(const double *const Source) { return _mm_loadu_pd(Source); }
+		static Vector Splat(const double *const Source) { return _mm_loadu_pd(Source); }
+		static void Store(double *const Target, const Vector Value) { _mm_storeu_pd(Target, Value); }
+		static Vector Add(const Vector Left, const Vector Right) { return _mm_add_pd(Left, Right); }
+		static Vector Sub(const Vector Left, const Vector Right) { return _mm_sub_pd(Left, Right); }
+
+		static Vector Mul(const Vector Left, const Vector Right)
+		{
+			//   (a + bi)(c + di) = (ac - bd) + (bc + ad)i
+			const Vector Re = _mm_unpacklo_pd(Right, Right);
+			const Vector Im = _mm_unpackhi_pd(Right, Right);
+			const Vector Swapped = _mm_shuffle_pd(Left, Left, 1);
+			return _mm_add_pd(_mm_mul_pd(Left, Re), _mm_xor_pd(_mm_mul_pd(Swapped, Im), _mm_set_pd(0., -0.)));
+		}
+
+		static Vector MulNegI(const Vector Value)
+		{
+			//   (a + bi)(-i) = b - ai
+			return _mm_xor_pd(_mm_shuffle_pd(Value, Value, 1), _mm_set_pd(-0., 0.));
+		}
+
+		static Vector Conjugate(const Vector Value) { return _mm_xor_pd(Value, _mm_set_pd(-0., 0.)); }
+	};
+
+	//   SSE2 traits, two single precision complex numbers per register
+	struct SSE2FloatTraits
+	{
+		typedef float Real;
+		enum { Width = 2 };
+		typedef __m128 Vector;
+		typedef ScalarTraits<float> Narrow;
+		typedef ScalarTraits<float> Single;
+
+		static Vector Load(const float *const Source) { return _mm_loadu_ps(Source); }
+		static Vector Splat(const float *const Source)
+		{
+			return _mm_castpd_ps(_mm_load1_pd(reinterpret_cast<const double*>(Source)));
+		}
+		static void Store(float *const Target, const Vector Value) { _mm_storeu_ps(Target, Value); }
+		static Vector Add(const Vector Left, const Vector Right) { return _mm_add_ps(Left, Right); }
+		static Vector Sub(const Vector Left, const Vector Right) { return _mm_sub_ps(Left, Right); }
+
+		static Vector Mul(const Vector Left, const Vector Right)
+		{
+			//   (a + bi)(c + di) = (ac - bd) + (bc + ad)i
+			const Vector Re = _mm_shuffle_ps(Right, Right, _MM_SHUFFLE(2, 2, 0, 0));
+			const Vector Im = _mm_shuffle_ps(Right, Right, _MM_SHUFFLE(3, 3, 1, 1));
+			const Vector Swapped = _mm_shuffle_ps(Left, Left, _MM_SHUFFLE(2, 3, 0, 1));
+			return _mm_add_ps(_mm_mul_ps(Left, Re), _mm_xor_ps(_mm_mul_ps(Swapped, Im), _mm_set_ps(0.f, -0.f, 0.f, -0.f)));
+		}
+
+		static Vector MulNegI(const Vector Value)
+		{
+			//   (a + bi)(-i) = b - ai
+			return _mm_xor_ps(_mm_shuffle_ps(Value, Value, _MM_SHUFFLE(2, 3, 0, 1)), _mm_set_ps(-0.f, 0.f, -0.f, 0.f));
+		}
+
+		static Vector Conjugate(const Vector Value) { return _mm_xor_ps(Value, _mm_set_ps(-0.f, 0.f, -0.f, 0.f)); }
+	};
+#endif
+
+	//   One radix-2 stage, groups of the same pair are contiguous
+	//   and processed Width at once
+	template <class V>
+	void Radix2Stage(typename V::Real *const Data, const unsigned int N, const unsigned int Step,
+		const typename V::Real *const Factors, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		typedef typename V::Vector Vector;
+		const unsigned int Jump = Step << 1;
+		for (unsigned int Pair = 0; Pair < N; Pair += Jump)
+		{
+			Real *const Top = Data + 2 * Pair;
+			Real *const Bottom = Top + 2 * Step;
+			for (unsigned int Group = 0; Group < Step; Group += V::Width)
+			{
+				Vector Factor = V::Load(Factors + 2 * Group);
+				if (Inverse)
+					Factor = V::Conjugate(Factor);
+				const Vector Product = V::Mul(V::Load(Bottom + 2 * Group), Factor);
+				const Vector Value = V::Load(Top + 2 * Group);
+				V::Store(Bottom + 2 * Group, V::Sub(Value, Product));
+				V::Store(Top + 2 * Group, V::Add(Value, Product));
+			}
+		}
+	}
+
+	//   Radix-2 stage with the widest traits the stage can fill
+	template <class V>
+	void Radix2Fit(typename V::Real *const Data, const unsigned int N, const unsigned int Step,
+		const typename V::Real *const Factors, const bool Inverse)
+	{
+		if (Step < V::Width)
+			Radix2Fit<typename V::Narrow>(Data, N, Step, Factors, Inverse);
+		else
+			Radix2Stage<V>(Data, N, Step, Factors, Inverse);
+	}
+
+	//   Radix-2 butterflies over bit-reversed data, stage after stage
+	template <class V>
+	void PerformRadix2(typename V::Real *const Data, const unsigned int N, const typename V::Real *const Twiddles, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		for (unsigned int Step = 1; Step < N; Step <<= 1)
+		{
+			//   Transform factors of this stage
+			const Real *const Factors = Twiddles + 2 * (Step - 1);
+			Radix2Fit<V>(Data, N, Step, Factors, Inverse);
+		}
+	}
+
+	//   One radix-2 stage of an output-pruned transform, groups
+	//   [Low, High) feed no kept bin and are skipped
+	template <class V>
+	void PrunedStage(typename V::Real *const Data, const unsigned int N, const unsigned int Step,
+		const unsigned int Low, const unsigned int High, const typename V::Real *const Factors, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		typedef typename V::Vector Vector;
+		const unsigned int Jump = Step << 1;
+		//   Skipped range shrunk to whole registers
+		const unsigned int First = (Low + V::Width - 1) / V::Width * V::Width;
+		const unsigned int Last = High / V::Width * V::Width > First ? High / V::Width * V::Width : First;
+		for (unsigned int Pair = 0; Pair < N; Pair += Jump)
+		{
+			Real *const Top = Data + 2 * Pair;
+			Real *const Bottom = Top + 2 * Step;
+			for (unsigned int Group = 0; Group < Step; Group = Group + V::Width == First ? Last : Group + V::Width)
+			{
+				Vector Factor = V::Load(Factors + 2 * Group);
+				if (Inverse)
+					Factor = V::Conjugate(Factor);
+				const Vector Product = V::Mul(V::Load(Bottom + 2 * Group), Factor);
+				const Vector Value = V::Load(Top + 2 * Group);
+				V::Store(Bottom + 2 * Group, V::Sub(Value, Product));
+				V::Store(Top + 2 * Group, V::Add(Value, Product));
+			}
+		}
+	}
+
+	//   Pruned radix-2 stage with the widest traits the stage can fill
+	template <class V>
+	void PrunedFit(typename V::Real *const Data, const unsigned int N, const unsigned int Step,
+		const unsigned int Low, const unsigned int High, const typename V::Real *const Factors, const bool Inverse)
+	{
+		if (Step < V::Width)
+			PrunedFit<typename V::Narrow>(Data, N, Step, Low, High, Factors, Inverse);
+		else
+			PrunedStage<V>(Data, N, Step, Low, High, Factors, Inverse);
+	}
+
+	//   Output-pruned radix-2 stages from half-length Step on, bin k
+	//   of the result takes bin k mod 2 * Step of every block, so a group
+	//   is skipped when neither of its outputs is below Bins or, with
+	//   Mirror, above 2 * Step - Bins
+	template <class V>
+	void PerformPruned(typename V::Real *const Data, const unsigned int N, const unsigned int Step,
+		const unsigned int Bins, const bool Mirror, const typename V::Real *const Twiddles, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		for (unsigned int Half = Step; Half < N; Half <<= 1)
+		{
+			//   Transform factors of this stage
+			const Real *const Factors = Twiddles + 2 * (Half - 1);
+			//   Stages the kept bins fill are done in full
+			const bool Full = Mirror ? 2 * Bins > Half : Bins >= Half;
+			const unsigned int Low = Full ? Half : Bins;
+			const unsigned int High = Full || !Mirror ? Half : Half + 1 - Bins;
+			PrunedFit<V>(Data, N, Half, Low, High, Factors, Inverse);
+		}
+	}
+
+	//   One radix-4 stage merging four transforms of length Quarter,
+	//   in bit-reversed order they hold samples 4m, 4m + 2, 4m + 1, 4m + 3
+	//     Singles - factors W^g of length 4 * Quarter
+	//     Doubles - factors W^2g
+	//     Triples - factors W^3g
+	template <class V>
+	void Radix4Stage(typename V::Real *const Data, const unsigned int N, const unsigned int Quarter,
+		const typename V::Real *const Singles, const typename V::Real *const Doubles, const typename V::Real *const Triples, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		typedef typename V::Vector Vector;
+		const unsigned int Jump = Quarter << 2;
+		for (unsigned int Block = 0; Block < N; Block += Jump)
+		{
+			Real *const First = Data + 2 * Block;
+			Real *const Second = First + 2 * Quarter;
+			Real *const Third = Second + 2 * Quarter;
+			Real *const Fourth = Third + 2 * Quarter;
+			for (unsigned int Group = 0; Group < Quarter; Group += V::Width)
+			{
+				const unsigned int Offset = 2 * Group;
+				Vector Single = V::Load(Singles + Offset);
+				Vector Double = V::Load(Doubles + Offset);
+				Vector Triple = V::Load(Triples + Offset);
+				if (Inverse)
+				{
+					Single = V::Conjugate(Single);
+					Double = V::Conjugate(Double);
+					Triple = V::Conjugate(Triple);
+				}
+				const Vector Term0 = V::Load(First + Offset);
+				const Vector Term1 = V::Mul(V::Load(Second + Offset), Double);
+				const Vector Term2 = V::Mul(V::Load(Third + Offset), Single);
+				const Vector Term3 = V::Mul(V::Load(Fourth + Offset), Triple);
+				const Vector Sum01 = V::Add(Term0, Term1);
+				const Vector Diff01 = V::Sub(Term0, Term1);
+				const Vector Sum23 = V::Add(Term2, Term3);
+				//   -i (Term2 - Term3), sign flips for inverse transform
+				const Vector Rotated = V::MulNegI(V::Sub(Term2, Term3));
+				V::Store(First + Offset, V::Add(Sum01, Sum23));
+				V::Store(Third + Offset, V::Sub(Sum01, Sum23));
+				V::Store(Second + Offset, Inverse ? V::Sub(Diff01, Rotated) : V::Add(Diff01, Rotated));
+				V::Store(Fourth + Offset, Inverse ? V::Add(Diff01, Rotated) : V::Sub(Diff01, Rotated));
+			}
+		}
+	}
+
+	//   Radix-4 stage with the widest traits the stage can fill
+	template <class V>
+	void Radix4Fit(typename V::Real *const Data, const unsigned int N, const unsigned int Quarter,
+		const typename V::Real *const Singles, const typename V::Real *const Doubles,
+		const typename V::Real *const Triples, const bool Inverse)
+	{
+		if (Quarter < V::Width)
+			Radix4Fit<typename V::Narrow>(Data, N, Quarter, Singles, Doubles, Triples, Inverse);
+		else
+			Radix4Stage<V>(Data, N, Quarter, Singles, Doubles, Triples, Inverse);
+	}
+
+	//   Radix-8 first stage, transforms of eight bit-reversed entries
+	//   with constant factors 1, W8, -i and W8^3, traits of width one
+	template <class V>
+	void Radix8Stage(typename V::Real *const Data, const unsigned int N, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		typedef typename V::Vector Vector;
+		const Real Root = Real(0.70710678118654752440);
+		const Real Constants[4] = { Root, Inverse ? Root : -Root, -Root, Inverse ? Root : -Root };
+		const Vector Eighth = V::Load(Constants);
+		const Vector ThreeEighths = V::Load(Constants + 2);
+		for (unsigned int Block = 0; Block < N; Block += 8)
+		{
+			Real *const Entry = Data + 2 * Block;
+			//   Dyads
+			Vector Value[8];
+			for (int Index = 0; Index < 8; Index += 2)
+			{
+				const Vector Left = V::Load(Entry + 2 * Index);
+				const Vector Right = V::Load(Entry + 2 * Index + 2);
+				Value[Index] = V::Add(Left, Right);
+				Value[Index + 1] = V::Sub(Left, Right);
+			}
+			//   Quadruples, factors 1 and -i
+			for (int Index = 0; Index < 8; Index += 4)
+			{
+				const Vector Sum = V::Add(Value[Index], Value[Index + 2]);
+				const Vector Diff = V::Sub(Value[Index], Value[Index + 2]);
+				const Vector Rotated = V::MulNegI(Value[Index + 3]);
+				const Vector Odd = Value[Index + 1];
+				Value[Index] = Sum;
+				Value[Index + 2] = Diff;
+				Value[Index + 1] = Inverse ? V::Sub(Odd, Rotated) : V::Add(Odd, Rotated);
+				Value[Index + 3] = Inverse ? V::Add(Odd, Rotated) : V::Sub(Odd, Rotated);
+			}
+			//   Octad, factors 1, W8, -i and W8^3
+			const Vector Rotated = V::MulNegI(Value[6]);
+			const Vector Product[4] =
+			{
+				Value[4],
+				V::Mul(Value[5], Eighth),
+				Rotated,
+				V::Mul(Value[7], ThreeEighths)
+			};
+			for (int Index = 0; Index < 4; ++Index)
+			{
+				//   Inverse rotation by i is the negated rotation by -i
+				const bool Negate = Inverse && Index == 2;
+				V::Store(Entry + 2 * Index, Negate ? V::Sub(Value[Index], Product[Index]) : V::Add(Value[Index], Product[Index]));
+				V::Store(Entry + 2 * Index + 8, Negate ? V::Add(Value[Index], Product[Index]) : V::Sub(Value[Index], Product[Index]));
+			}
+		}
+	}
+
+	//   Radix-4 butterflies over bit-reversed data, with a radix-2 or
+	//   radix-8 first stage when the number of dyadic stages is odd
+	//     Twiddles - factors of all radix-2 stages
+	//     Triples  - factors W^3g of all radix-4 stages
+	template <class V>
+	void PerformRadix4(typename V::Real *const Data, const unsigned int N, const typename V::Real *const Twiddles,
+		const typename V::Real *const Triples, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		typedef typename V::Single Single;
+		//   Count dyadic stages
+		unsigned int Stages = 0;
+		while ((1u << Stages) < N)
+			++Stages;
+		unsigned int Quarter = 1;
+		if (Stages & 1)
+		{
+			if (Stages == 1)
+			{
+				Radix2Stage<Single>(Data, N, 1, Twiddles, Inverse);
+				return;
+			}
+			Radix8Stage<Single>(Data, N, Inverse);
+			Quarter = 8;
+		}
+		for (; Quarter < N; Quarter <<= 2)
+		{
+			const Real *const Singles = Twiddles + 2 * (2 * Quarter - 1);
+			const Real *const Doubles = Twiddles + 2 * (Quarter - 1);
+			const Real *const Factors = Triples + 2 * (Quarter - 1);
+			Radix4Fit<V>(Data, N, Quarter, Singles, Doubles, Factors, Inverse);
+		}
+	}
+
+	//   One Stockham autosort stage, transforms of length 2 * Half
+	//   interleaved with Stride, output goes to the other buffer
+	//     Factors - factors W^p of length 2 * Half
+	template <class V>
+	void StockhamStage(const typename V::Real *const Input, typename V::Real *const Output, const unsigned int Half,
+		const unsigned int Stride, const typename V::Real *const Factors, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		typedef typename V::Vector Vector;
+		for (unsigned int Position = 0; Position < Half; ++Position)
+		{
+			Vector Factor = V::Splat(Factors + 2 * Position);
+			if (Inverse)
+				Factor = V::Conjugate(Factor);
+			const Real *const Top = Input + 2 * Stride * Position;
+			const Real *const Bottom = Top + 2 * Stride * Half;
+			Real *const Even = Output + 4 * Stride * Position;
+			Real *const Odd = Even + 2 * Stride;
+			for (unsigned int Offset = 0; Offset < 2 * Stride; Offset += 2 * V::Width)
+			{
+				const Vector Left = V::Load(Top + Offset);
+				const Vector Right = V::Load(Bottom + Offset);
+				V::Store(Even + Offset, V::Add(Left, Right));
+				V::Store(Odd + Offset, V::Mul(V::Sub(Left, Right), Factor));
+			}
+		}
+	}
+
+	//   Stockham stage with the widest traits the stage can fill
+	template <class V>
+	void StockhamFit(const typename V::Real *const Input, typename V::Real *const Output, const unsigned int Half,
+		const unsigned int Stride, const typename V::Real *const Factors, const bool Inverse)
+	{
+		if (Stride < V::Width)
+			StockhamFit<typename V::Narrow>(Input, Output, Half, Stride, Factors, Inverse);
+		else
+			StockhamStage<V>(Input, Output, Half, Stride, Factors, Inverse);
+	}
+
+	//   Stockham autosort transform in natural order, stages ping-pong
+	//   between output and work buffers so the last one lands in output
+	//     Input may equal Output, Work holds N complex numbers
+	template <class V>
+	void PerformStockham(const typename V::Real *const Input, typename V::Real *const Output, typename V::Real *const Work,
+		const unsigned int N, const typename V::Real *const Twiddles, const bool Inverse)
+	{
+		typedef typename V::Real Real;
+		unsigned int Stages = 0;
+		while ((1u << Stages) < N)
+			++Stages;
+		//   First target chosen so that the last stage writes output,
+		//   inplace transforms start in work buffer and copy back if needed
+		const bool InPlace = Input == Output;
+		Real *Target = !InPlace && (Stages & 1) ? Output : Work;
+		const Real *Source = Input;
+		unsigned int Stride = 1;
+		for (unsigned int Half = N >> 1; Half > 0; Half >>= 1, Stride <<= 1)
+		{
+			const Real *const Factors = Twiddles + 2 * (Half - 1);
+			StockhamFit<V>(Source, Target, Half, Stride, Factors, Inverse);
+			Source = Target;
+			Target = Target == Work ? Output : Work;
+		}
+		if (Source != Output)
+			for (unsigned int Position = 0; Position < 2 * N; ++Position)
+				Output[Position] = Source[Position];
+	}
+}
+
+#endif
@@ -0,0 +1,62 @@
+//   fftsse2.cpp - SSE2 butterfly kernels, one double
+//   or two single precision complex numbers per register
+
+//   Include declaration file
+#include "fftkernels.h"
+
+#if FFT_SIMD
+
+//   Include generic kernels
+#include "fftsimd.h"
+
+//   RADIX-2 BUTTERFLIES OVER BIT-REVERSED DATA
+void PerformSSE2(double *const Data, const unsigned int N, const double *const Twiddles, const bool Inverse)
+{
+	PerformRadix2<SSE2Traits>(Data, N, Twiddles, Inverse);
+}
+
+void PerformSSE2(float *const Data, const unsigned int N, const float *const Twiddles, const bool Inverse)
+{
+	PerformRadix2<SSE2FloatTraits>(Data, N, Twiddles, Inverse);
+}
+
+//   OUTPUT-PRUNED RADIX-2 STAGES OVER BIT-REVERSED DATA
+void PerformPrunedSSE2(double *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const double *const Twiddles, const bool Inverse)
+{
+	PerformPruned<SSE2Traits>(Data, N, Step, Bins, Mirror, Twiddles, Inverse);
+}
+
+void PerformPrunedSSE2(float *const Data, const unsigned int N, const unsigned int Step, const unsigned int Bins,
+	const bool Mirror, const float *const Twiddles, const bool Inverse)
+{
+	PerformPruned<SSE2FloatTraits>(Data, N, Step, Bins, Mirror, Twiddles, Inverse);
+}
+
+//   RADIX-4 BUTTERFLIES OVER BIT-REVERSED DATA
+void PerformRadix4SSE2(double *const Data, const unsigned int N, const double *const Twiddles,
+	const double *const Triples, const bool Inverse)
+{
+	PerformRadix4<SSE2Traits>(Data, N, Twiddles, Triples, Inverse);
+}
+
+void PerformRadix4SSE2(float *const Data, const unsigned int N, const float *const Twiddles,
+	const float *const Triples, const bool Inverse)
+{
+	PerformRadix4<SSE2FloatTraits>(Data, N, Twiddles, Triples, Inverse);
+}
+
+//   STOCKHAM AUTOSORT TRANSFORM
+void PerformStockhamSSE2(const double *const Input, double *const Output, double *const Work,
+	const unsigned int N, const double *const Twiddles, const bool Inverse)
+{
+	PerformStockham<SSE2Traits>(Input, Output, Work, N, Twiddles, Inverse);
+}
+
+void PerformStockhamSSE2(const float *const Input, float *const Output, float *const Work,
+	const unsigned int N, const float *const Twiddles, const bool Inverse)
+{
+	PerformStockham<SSE2FloatTraits>(Input, Output, Work, N, Twiddles, Inverse);
+}
+
+#endif
@@ -0,0 +1,101 @@
+// levels.cpp - power, magnitude and fast logarithm kernels, SSE2 with a scalar tail
+
+#include "levels.h"
+#include "simd.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// log2 x = e + log2 m for x = m 2^e with m in [sqrt(1/2), sqrt(2)), and
+// log2 m = 2 / ln 2 (t + t^3 / 3 + t^5 / 5 + t^7 / 7 + ...) with t = (m - 1) / (m + 1),
+// |t| < 0.172, so the first four terms leave under 5e-8, the rest is float rounding
+static const float twoOverLn2 = 2.8853900817779268f;
+static const float log10Of2 = 0.30102999566398120f;
+static const int32_t sqrtHalfBits = 0x3f3504f3;
+
+static inline float fastLog2(float x) {
+	if (!(x >= FLT_MIN)) {
+		x = FLT_MIN;
+	}
+	int32_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	// shift the exponent so the mantissa lands in [sqrt(1/2), sqrt(2))
+	const int32_t exponent = ((bits - sqrtHalfBits) >> 23);
+	bits -= exponent << 23;
+	float m;
+	std::memcpy(&m, &bits, sizeof(m));
+	const float t = (m - 1) / (m + 1);
+	const float t2 = t * t;
+	const float series = t * (1 + t2 * (1.0f / 3 + t2 * (1.0f / 5 + t2 * (1.0f / 7))));
+	return (float)exponent + twoOverLn2 * series;
+}
+
+#if SIMD_SSE2
+static inline __m128 fastLog2(__m128 x) {
+	x = _mm_max_ps(x, _mm_set1_ps(FLT_MIN));
+	__m128i bits = _mm_castps_si128(x);
+	const __m128i exponent = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(sqrtHalfBits)), 23);
+	bits = _mm_sub_epi32(bits, _mm_slli_epi32(exponent, 23));
+	const __m128 m = _mm_castsi128_ps(bits);
+	const __m128 one = _mm_set1_ps(1);
+	const __m128 t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+	const __m128 t2 = _mm_mul_ps(t, t);
+	__m128 series = _mm_add_ps(_mm_set1_ps(1.0f / 5), _mm_mul_ps(t2, _mm_set1_ps(1.0f / 7)));
+	series = _mm_add_ps(_mm_set1_ps(1.0f / 3), _mm_mul_ps(t2, series));
+	series = _mm_add_ps(one, _mm_mul_ps(t2, series));
+	series = _mm_mul_ps(t, series);
+	return _mm_add_ps(_mm_cvtepi32_ps(exponent), _mm_mul_ps(_mm_set1_ps(twoOverLn2), series));
+}
+#endif
+
+void spectrumLevels(const fcomplex* const bins, float* const result, size_t count, LevelKind kind, float slope, float offset) {
+	const float* const values = reinterpret_cast<const float*>(bins);
+	// log10 |z|^2 = log10(2) log2 |z|^2
+	const float scale = slope * log10Of2;
+	size_t i = 0;
+#if SIMD_SSE2
+	for (; i + 4 <= count; i += 4) {
+		// two registers of interleaved bins, squared and summed pairwise
+		const __m128 low = _mm_loadu_ps(values + 2 * i);
+		const __m128 high = _mm_loadu_ps(values + 2 * i + 4);
+		const __m128 lowSquares = _mm_mul_ps(low, low);
+		const __m128 highSquares = _mm_mul_ps(high, high);
+		const __m128 real = _mm_shuffle_ps(lowSquares, highSquares, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 imag = _mm_shuffle_ps(lowSquares, highSquares, _MM_SHUFFLE(3, 1, 3, 1));
+		__m128 level = _mm_add_ps(real, imag);
+		if (kind == magnitudeLevel) {
+			level = _mm_sqrt_ps(level);
+		}
+		else if (kind == decibelLevel) {
+			level = _mm_add_ps(_mm_mul_ps(fastLog2(level), _mm_set1_ps(scale)), _mm_set1_ps(offset));
+		}
+		_mm_storeu_ps(result + i, level);
+	}
+#endif
+	for (; i < count; i++) {
+		const float re = values[2 * i], im = values[2 * i + 1];
+		float level = re * re + im * im;
+		if (kind == magnitudeLevel) {
+			level = sqrtf(level);
+		}
+		else if (kind == decibelLevel) {
+			level = fastLog2(level) * scale + offset;
+		}
+		result[i] = level;
+	}
+}
+
+void decibels(const float* const values, float* const result, size_t count, float slope, float offset) {
+	const float scale = slope * log10Of2;
+	size_t i = 0;
+#if SIMD_SSE2
+	for (; i + 4 <= count; i += 4) {
+		const __m128 level = fastLog2(_mm_loadu_ps(values + i));
+		_mm_storeu_ps(result + i, _mm_add_ps(_mm_mul_ps(level, _mm_set1_ps(scale)), _mm_set1_ps(offset)));
+	}
+#endif
+	for (; i < count; i++) {
+		result[i] = fastLog2(values[i]) * scale + offset;
+	}
+}
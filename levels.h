@@ -0,0 +1,28 @@
+// levels.h - batch conversion of spectrum bins and band powers into levels
+
+#ifndef AUDIOANALYSER_LEVELS_H
+#define AUDIOANALYSER_LEVELS_H
+
+#include "complex.h"
+#include <cstddef>
+
+// what spectrumLevels writes for each bin
+enum LevelKind
+{
+	powerLevel,
+	magnitudeLevel,
+	decibelLevel
+};
+
+// turn count complex bins into power |z|^2, magnitude |z|, or slope * log10(|z|^2) + offset,
+// four bins per step with SSE2 where the target has it
+void spectrumLevels(const fcomplex* bins, float* result, size_t count, LevelKind kind, float slope = 1, float offset = 0);
+
+// result[i] = slope * log10(values[i]) + offset, values below the smallest normal float
+// are taken as that float, so silence gives a finite floor instead of minus infinity;
+// the logarithm is a short series in place of libm, its error in log10 stays below
+// 2e-7 times the larger of 1 and the logarithm itself, far under what a bar can show,
+// result may equal values
+void decibels(const float* values, float* result, size_t count, float slope, float offset);
+
+#endif
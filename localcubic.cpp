@@ -0,0 +1,193 @@
+// localcubic.cpp - PCHIP and Akima tangents and segment coefficients, SSE2 with a scalar tail
+
+#include "localcubic.h"
+#include "simd.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+const char* interpolationName(int mode) {
+	switch (mode) {
+	case noInterpolation:
+		return "Off";
+	case splineInterpolation:
+		return "Cubic Spline";
+	case pchipInterpolation:
+		return "PCHIP";
+	case akimaInterpolation:
+		return "Akima";
+	default:
+		return "Unknown";
+	}
+}
+
+#if SIMD_SSE2
+// mask ? a : b
+static inline __m128d select(__m128d mask, __m128d a, __m128d b) {
+	return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+static inline __m128d absolute(__m128d x) {
+	return _mm_andnot_pd(_mm_set1_pd(-0.0), x);
+}
+#endif
+
+// harmonic mean of the slopes either side when they share a sign, else flat,
+// it never exceeds twice the smaller slope, which keeps both segments monotone
+static void pchipTangents(const double* const slopes, double* const tangents, size_t begin, size_t end) {
+	size_t i = begin;
+#if SIMD_SSE2
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d two = _mm_set1_pd(2);
+	for (; i + 2 <= end; i += 2) {
+		const __m128d before = _mm_loadu_pd(slopes + i + 1);
+		const __m128d after = _mm_loadu_pd(slopes + i + 2);
+		const __m128d product = _mm_mul_pd(before, after);
+		// lanes with opposite signs may divide by zero, the mask drops them
+		const __m128d mean = _mm_div_pd(_mm_mul_pd(two, product), _mm_add_pd(before, after));
+		_mm_storeu_pd(tangents + i, _mm_and_pd(_mm_cmpgt_pd(product, zero), mean));
+	}
+#endif
+	for (; i < end; i++) {
+		const double before = slopes[i + 1], after = slopes[i + 2];
+		const double product = before * after;
+		tangents[i] = product > 0 ? 2 * product / (before + after) : 0;
+	}
+}
+
+// mean of the slopes either side, each weighted by how much the two slopes beyond
+// the other one differ, so the tangent sides with the straighter neighbourhood
+static void akimaTangents(const double* const slopes, double* const tangents, size_t begin, size_t end) {
+	size_t i = begin;
+#if SIMD_SSE2
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d half = _mm_set1_pd(0.5);
+	for (; i + 2 <= end; i += 2) {
+		const __m128d farBefore = _mm_loadu_pd(slopes + i);
+		const __m128d before = _mm_loadu_pd(slopes + i + 1);
+		const __m128d after = _mm_loadu_pd(slopes + i + 2);
+		const __m128d farAfter = _mm_loadu_pd(slopes + i + 3);
+		const __m128d weightBefore = absolute(_mm_sub_pd(farAfter, after));
+		const __m128d weightAfter = absolute(_mm_sub_pd(before, farBefore));
+		const __m128d sum = _mm_add_pd(weightBefore, weightAfter);
+		const __m128d weighted = _mm_div_pd(_mm_add_pd(_mm_mul_pd(weightBefore, before), _mm_mul_pd(weightAfter, after)), sum);
+		const __m128d plain = _mm_mul_pd(half, _mm_add_pd(before, after));
+		_mm_storeu_pd(tangents + i, select(_mm_cmpgt_pd(sum, zero), weighted, plain));
+	}
+#endif
+	for (; i < end; i++) {
+		const double before = slopes[i + 1], after = slopes[i + 2];
+		const double weightBefore = std::fabs(slopes[i + 3] - after);
+		const double weightAfter = std::fabs(before - slopes[i]);
+		const double sum = weightBefore + weightAfter;
+		tangents[i] = sum > 0 ? (weightBefore * before + weightAfter * after) / sum : 0.5 * (before + after);
+	}
+}
+
+// cubic Hermite coefficients of segments [begin, end) from their slope and end tangents
+static void segments(const double* const slopes, const double* const tangents, double* const squares, double* const cubes,
+	size_t begin, size_t end, double spacing) {
+	const double inverse = 1 / spacing;
+	const double inverseSquare = inverse * inverse;
+	size_t i = begin;
+#if SIMD_SSE2
+	const __m128d two = _mm_set1_pd(2);
+	const __m128d three = _mm_set1_pd(3);
+	const __m128d scale = _mm_set1_pd(inverse);
+	const __m128d scaleSquare = _mm_set1_pd(inverseSquare);
+	for (; i + 2 <= end; i += 2) {
+		const __m128d slope = _mm_loadu_pd(slopes + i + 2);
+		const __m128d left = _mm_loadu_pd(tangents + i);
+		const __m128d right = _mm_loadu_pd(tangents + i + 1);
+		const __m128d square = _mm_sub_pd(_mm_sub_pd(_mm_mul_pd(three, slope), _mm_mul_pd(two, left)), right);
+		const __m128d cube = _mm_sub_pd(_mm_add_pd(left, right), _mm_mul_pd(two, slope));
+		_mm_storeu_pd(squares + i, _mm_mul_pd(square, scale));
+		_mm_storeu_pd(cubes + i, _mm_mul_pd(cube, scaleSquare));
+	}
+#endif
+	for (; i < end; i++) {
+		const double slope = slopes[i + 2], left = tangents[i], right = tangents[i + 1];
+		squares[i] = (3 * slope - 2 * left - right) * inverse;
+		cubes[i] = (left + right - 2 * slope) * inverseSquare;
+	}
+}
+
+void LocalCubic::fit(double newOrigin, double newSpacing, const double* const newValues, size_t newCount, bool newAkima) {
+	assert(newCount > 2 && newSpacing > 0);
+	size_t first = 0, last = newCount - 1;
+	if (newCount == count && newAkima == akima && newOrigin == origin && newSpacing == spacing) {
+		// only the knots between the first and last changed value need new neighbours
+		while (first < count && newValues[first] == values[first]) {
+			first++;
+		}
+		if (first == count) {
+			return;
+		}
+		while (newValues[last] == values[last]) {
+			last--;
+		}
+	}
+	else {
+		count = newCount;
+		akima = newAkima;
+		origin = newOrigin;
+		spacing = newSpacing;
+		values.resize(count);
+		slopes.resize(count + 3);
+		tangents.resize(count);
+		squares.resize(count - 1);
+		cubes.resize(count - 1);
+	}
+	std::copy(newValues + first, newValues + last + 1, values.data() + first);
+	refit(first, last);
+}
+
+void LocalCubic::refit(size_t first, size_t last) {
+	// a knot moves the slopes of the segments on either side, those reach the tangents
+	// two knots away, and those in turn the segments ending there
+	const size_t firstSlope = first > 0 ? first - 1 : 0;
+	const size_t endSlope = std::min(last + 1, count - 1);
+	const double inverse = 1 / spacing;
+	for (size_t i = firstSlope; i < endSlope; i++) {
+		slopes[i + 2] = (values[i + 1] - values[i]) * inverse;
+	}
+	// slopes past the ends continue the trend of the outer two, so the outer
+	// tangents are computed like every other one
+	slopes[1] = 2 * slopes[2] - slopes[3];
+	slopes[0] = 2 * slopes[1] - slopes[2];
+	slopes[count + 1] = 2 * slopes[count] - slopes[count - 1];
+	slopes[count + 2] = 2 * slopes[count + 1] - slopes[count];
+
+	const size_t firstTangent = first > 2 ? first - 2 : 0;
+	const size_t endTangent = std::min(last + 3, count);
+	if (akima) {
+		akimaTangents(slopes.data(), tangents.data(), firstTangent, endTangent);
+	}
+	else {
+		pchipTangents(slopes.data(), tangents.data(), firstTangent, endTangent);
+	}
+
+	const size_t firstSegment = first > 3 ? first - 3 : 0;
+	const size_t endSegment = std::min(last + 3, count - 1);
+	segments(slopes.data(), tangents.data(), squares.data(), cubes.data(), firstSegment, endSegment, spacing);
+}
+
+void LocalCubic::evaluate(double x0, double dx, size_t points, double* const result) const {
+	assert(dx > 0);
+	const double inverse = 1 / spacing;
+	const double end = origin + (count - 1) * spacing;
+	for (size_t k = 0; k < points; k++) {
+		const double x = x0 + k * dx;
+		if (!(x > origin)) {
+			result[k] = values[0];
+		}
+		else if (x >= end) {
+			result[k] = values[count - 1];
+		}
+		else {
+			const size_t i = std::min((size_t)((x - origin) * inverse), count - 2);
+			const double t = x - (origin + i * spacing);
+			result[k] = values[i] + t * (tangents[i] + t * (squares[i] + t * cubes[i]));
+		}
+	}
+}
@@ -0,0 +1,58 @@
+// localcubic.h - piecewise cubic curves whose tangents depend only on neighbouring knots
+
+#ifndef AUDIOANALYSER_LOCALCUBIC_H
+#define AUDIOANALYSER_LOCALCUBIC_H
+
+#include "buffer.h"
+#include <cstddef>
+
+// how the bars are joined into a curve when interpolating
+enum InterpolationMode
+{
+	noInterpolation,
+	splineInterpolation,
+	pchipInterpolation,
+	akimaInterpolation,
+	interpolationCount
+};
+
+const char* interpolationName(int mode);
+
+// Hermite cubic through uniformly spaced knots, the tangent at a knot is taken from the
+// slopes of at most two segments on either side, PCHIP's harmonic mean keeps every segment
+// monotone between its knots so the curve never overshoots the bars, Akima's weighted mean
+// rounds peaks more naturally but may overshoot them; without a global solve every
+// tangent and segment is one independent step of an SSE2 pass, and a refit only
+// recomputes those next to knots whose values changed
+class LocalCubic
+{
+public:
+	LocalCubic() : count(0), akima(false), origin(0), spacing(1) {}
+
+	LocalCubic(const LocalCubic&) = delete;
+	LocalCubic& operator=(const LocalCubic&) = delete;
+
+	// fit through values[i] at origin + i * spacing, count > 2, spacing > 0
+	void fit(double origin, double spacing, const double* values, size_t count, bool akima);
+
+	// result[i] = curve at x0 + i * dx, dx > 0, held flat past the outer knots
+	void evaluate(double x0, double dx, size_t points, double* result) const;
+
+private:
+	// recompute the padded slopes, tangents and segments fed by knots [first, last]
+	void refit(size_t first, size_t last);
+
+	size_t count;
+	bool akima;
+	double origin;
+	double spacing;
+	AlignedBuffer<double> values;
+	// slope of segment i at slopes[i + 2], extrapolated two further on either side
+	AlignedBuffer<double> slopes;
+	AlignedBuffer<double> tangents;
+	// segment i is values[i] + tangents[i] t + squares[i] t^2 + cubes[i] t^3, t = x - knot i
+	AlignedBuffer<double> squares;
+	AlignedBuffer<double> cubes;
+};
+
+#endif
@@ -8,24 +8,30 @@
 #include "fft.h"
 #include "complex.h"
 #include "spline.h"
-
-const std::string version = "1.8.2";
-std::mutex mutex;
-std::vector<double> frequencies;
-std::vector<double> peaks;
+#include "buffer.h"
+#include "triplebuffer.h"
+#include "ringbuffer.h"
+#include "bandmap.h"
+#include "windowtable.h"
+#include "localcubic.h"
+#include "quadstream.h"
+#include "settings.h"
+#include "analyser.h"
+#include <cstring>
+#include <atomic>
+
+const std::string version = "1.9.0";
+// newest spectrum for the rendering thread
+TripleBuffer<SpectrumFrame> spectrum;
 const uint32_t WIDTH = 1920;
 const uint32_t HEIGHT = 1080;
 const uint32_t autoScaleCycles = 100;
-const uint32_t processingInterval = 15;
-const uint32_t bufferSize = 16384;
-uint16_t bars = 30;
+// most bars the interpolation curve is drawn through, it samples about one point per pixel
+const uint16_t interpolationBars = 512;
+// rate capture is started at
+uint32_t sampleRate = defaultRate;
 uint16_t autoScaleCount = 0;
-uint16_t maxFrequency = 2500;
-uint16_t peakDecay = 12;
 uint16_t divisions = 10;
-double scale1 = 285.0;
-double scale2 = 2.2e-9;
-double smoothing = 0.75;
 double averageMax = HEIGHT / 2;
 double colourChange = 3.5;
 double shadingRatio = 0;
@@ -33,98 +39,40 @@ double colourCounter = 0;
 double colourOffset = 512;
 double gapRatio = 0.7;
 bool autoScale = true;
-bool delayedPeaks = true;
-bool decaySmoothing = true;
 bool classic = false;
 bool borderless = false;
-bool inter = false;
+int inter = noInterpolation;
 sf::Color gradient[256 * 6];
 
 class Recorder : public sf::SoundRecorder
 {
+public:
+	Recorder(RingBuffer<sf::Int16>& samples) : samples(samples), dropped(0) {}
+
+private:
+	RingBuffer<sf::Int16>& samples;
+	std::atomic<uint64_t> dropped;
+
 	virtual bool onStart()
 	{
 		// initialize whatever has to be done before the capture starts
 		std::cout << "Recorder Started" << std::endl;
 		setProcessingInterval(sf::Time(sf::milliseconds(processingInterval)));
+		// the analysis follows whatever rate the device was opened at
+		captureRate = getSampleRate();
+		std::cout << "Sample Rate: " << captureRate << std::endl;
 		// return true to start the capture, or false to cancel it
 		return true;
 	}
 
-	double* truncate(complex* const data, size_t size, size_t newSize) {
-		// truncate the data array by averaging the values over chunks
-		double* result = new double[newSize];
-		double buffer;
-		double chunkSize = ((double)size / (double)newSize) / (20000.0 / (double)maxFrequency);
-		size_t chunk = 0;
-
-		for (double i = 0; i < size && chunk < newSize; i += chunkSize) {
-			buffer = 0;
-			for (size_t j = 0; j < chunkSize; j++) {
-				if (data[(int)floor(i) + j].norm() > 0) {
-					buffer += data[(int)floor(i) + j].norm();
-				}
-			}
-			result[chunk++] = buffer / chunkSize;
-		}
-
-		return result;
-	}
-
 	virtual bool onProcessSamples(const sf::Int16* samples, size_t sampleCount)
 	{
-		// do something useful with the new chunk of samples
-		complex* const complexSamples = new complex[bufferSize];
-		
-		for (int i = 0; i < bufferSize; i++) {
-			complexSamples[i] = i < sampleCount ? samples[i] : 0;
-		}
-
-		if (!CFFT::Forward(complexSamples, bufferSize)) {
-			std::cout << "Error: FFT execution failed" << std::endl;
-			return false;
+		// only queue the chunk, the analyser thread does the rest
+		const size_t queued = this->samples.push(samples, sampleCount);
+		if (queued < sampleCount) {
+			dropped += sampleCount - queued;
 		}
 
-		double* transform = truncate(complexSamples, bufferSize / 2, bars);
-
-		// protect access to variables of external threads
-		mutex.lock();
-
-		if (frequencies.size() == 0) {
-			for (int i = 0; i < bars; i++) {
-				double magnitude = log10(transform[i] * scale2) * scale1;
-				frequencies.push_back(magnitude);
-				peaks.push_back(magnitude);
-			}
-		}
-		else {
-			for (int i = 0; i < bars; i++) {
-				double magnitude = log10(transform[i] * scale2) * scale1;
-				if (decaySmoothing) {
-					frequencies[i] = magnitude > frequencies[i] ? magnitude : (frequencies[i] * smoothing + magnitude * (1 - smoothing));
-				}
-				else {
-					frequencies[i] = (frequencies[i] * smoothing + magnitude * (1 - smoothing));
-				}
-				if (delayedPeaks) {
-					if (frequencies[i] > peaks[i]) {
-						peaks[i] = frequencies[i];
-					}
-					else if (peaks[i] > 1) {
-						peaks[i] -= peakDecay;
-						if (frequencies[i] > peaks[i]) {
-							peaks[i] = frequencies[i];
-						}
-					}
-				}
-			}
-		}
-
-		mutex.unlock();
-
-		delete[] transform;
-		delete[] complexSamples;
-
 		// return true to continue the capture, or false to stop it
 		return true;
 	}
@@ -133,16 +81,96 @@ class Recorder : public sf::SoundRecorder
 	{
 		// clean up whatever has to be done after the capture is finished
 		std::cout << "Recorder Stopped" << std::endl;
+		std::cout << "Samples Dropped: " << dropped << std::endl;
+	}
+};
+
+
+// curve through the bar levels, fitted once per spectrum frame and sampled
+// across the whole width in one pass, the buffers are kept between frames
+// and only grow, so a steady bar count and width never allocate
+class Interpolation
+{
+public:
+	Interpolation() : fitted(0), bars(0), spacing(0), mode(noInterpolation) {}
+
+	// the levels of frame at points evenly spaced positions step apart from the left edge
+	// of the first bar, joined as the given InterpolationMode,
+	// refitted only when the frame, the mode or the positions change
+	const std::vector<double>& sample(const SpectrumFrame& frame, size_t points, double step, int newMode) {
+		const std::vector<double>& levels = frame.frequencies;
+		if (frame.number == fitted && levels.size() == bars && points == samples.size() && step == spacing && newMode == mode) {
+			return samples;
+		}
+		samples.resize(points);
+		// bar i is centred on i + 0.5, so the knots are uniform
+		// and each position finds its segment by arithmetic
+		if (newMode == splineInterpolation) {
+			spline.set_uniform_points(0.5, 1, levels.data(), levels.size());
+			spline.evaluate(0, step, points, samples.data());
+		}
+		else {
+			// local tangents only move next to the bars that changed
+			local.fit(0.5, 1, levels.data(), levels.size(), newMode == akimaInterpolation);
+			local.evaluate(0, step, points, samples.data());
+		}
+		fitted = frame.number;
+		bars = levels.size();
+		spacing = step;
+		mode = newMode;
+		return samples;
 	}
+
+private:
+	tk::spline spline;
+	LocalCubic local;
+	std::vector<double> samples;
+	uint64_t fitted;
+	size_t bars;
+	double spacing;
+	int mode;
 };
 
+// add an axis-aligned rectangle to a quad array, a negative height grows upwards
+// from y just like sf::RectangleShape with the same position and size
+void appendQuad(sf::VertexArray& quads, float x, float y, float width, float height, const sf::Color& colour) {
+	quads.append(sf::Vertex(sf::Vector2f(x, y), colour));
+	quads.append(sf::Vertex(sf::Vector2f(x + width, y), colour));
+	quads.append(sf::Vertex(sf::Vector2f(x + width, y + height), colour));
+	quads.append(sf::Vertex(sf::Vector2f(x, y + height), colour));
+}
+
+// the settings a frame is drawn with, copied under the lock at the start of every frame
+// so a key press can never change them halfway through the bars
+struct RenderSettings
+{
+	int inter;
+	bool delayedPeaks;
+	uint16_t bars;
+	double gapRatio;
+	bool classic;
+	uint16_t divisions;
+	double shadingRatio;
+	double colourOffset;
+	double colourChange;
+	bool borderless;
+};
 
-double interpolate(double pos) {
-	std::vector<double> X(frequencies.size());
-	for (size_t i = 0; i < frequencies.size(); i++) X[i] = i + 0.5;
-	tk::spline s;
-	s.set_points(X, frequencies);
-	return s(pos);
+RenderSettings renderSettings() {
+	RenderSettings view;
+	mutex.lock();
+	view.inter = inter;
+	view.delayedPeaks = delayedPeaks;
+	view.bars = bars;
+	view.gapRatio = gapRatio;
+	view.classic = classic;
+	view.divisions = divisions;
+	view.shadingRatio = shadingRatio;
+	view.colourOffset = colourOffset;
+	view.colourChange = colourChange;
+	view.borderless = borderless;
+	mutex.unlock();
+	return view;
 }
 
 void renderingThread(sf::RenderWindow* window)
@@ -164,12 +192,19 @@ void renderingThread(sf::RenderWindow* window)
 	std::cout << "[Ctrl + Enter] Classic/Normal Display Mode" << std::endl;
 	std::cout << "[Alt + Up/Down] Increase/Decrease Hue shift Speed" << std::endl;
 	std::cout << "[Alt + Right/Left] Increase/Decrease Shading" << std::endl;
-	std::cout << "[Alt + BackSpace] Enable/Disable Bar Interpolation" << std::endl;
+	std::cout << "[Alt + BackSpace] Cycle Bar Interpolation" << std::endl;
 	std::cout << "[Shift + Up/Down] Increase/Decrease Max Frequency" << std::endl;
 	std::cout << "[Shift + Right/Left] Increase/Decrease Peak Decay Speed" << std::endl;
+	std::cout << "[Shift + PageUp/PageDown] Increase/Decrease Peak Hold" << std::endl;
 	std::cout << "[Ctrl + Shift + Up/Down] Increase/Decrease Intensity Based Colour Offset" << std::endl;
 	std::cout << "[Ctrl + Shift + Left/Right] Increase/Decrese Bar Gap Ratio" << std::endl;
 	std::cout << "[Ctrl + Shift + Alt + Up/Down] Increase/Decrease Classic Mode Divisions" << std::endl;
+	std::cout << "[PageUp/PageDown] Increase/Decrease Analysis Hop" << std::endl;
+	std::cout << "[Home/End] Increase/Decrease Analysis Window" << std::endl;
+	std::cout << "[Tab] Cycle Band Spacing" << std::endl;
+	std::cout << "[Ctrl + Tab] Cycle Sample Rate" << std::endl;
+	std::cout << "[Shift + Tab] Enable/Disable Decimation" << std::endl;
+	std::cout << "[Insert] Cycle Window Function" << std::endl;
 
 	std::cout << "------------------------------------------------------------------------" << std::endl;
 
@@ -186,48 +221,70 @@ void renderingThread(sf::RenderWindow* window)
 	std::cout << "Max Frequency: " << maxFrequency << std::endl;
 	std::cout << "Decaying Peaks: " << delayedPeaks << std::endl;
 	std::cout << "Peak Decay Speed: " << peakDecay << std::endl;
+	std::cout << "Peak Hold: " << peakHold << std::endl;
 	std::cout << "Colour Intensity Offset: " << colourOffset << std::endl;
 	std::cout << "Bar Gap Ratio: " << gapRatio << std::endl;
 	std::cout << "Display Mode: " << classic << std::endl;
 	std::cout << "Classic Mode Divisions: " << divisions << std::endl;
-	std::cout << "Bar Interpolation: " << inter << std::endl;
+	std::cout << "Bar Interpolation: " << interpolationName(inter) << std::endl;
+	std::cout << "Analysis Window: " << windowSize << std::endl;
+	std::cout << "Analysis Hop: " << hopSize << std::endl;
+	std::cout << "Band Spacing: " << spacingName(spacing) << std::endl;
+	std::cout << "Sample Rate: " << sampleRate << std::endl;
+	std::cout << "Decimation: " << decimation << std::endl;
+	std::cout << "Window Function: " << windowName(windowType) << std::endl;
 
 	std::cout << "------------------------------------------------------------------------" << std::endl;
 
 	std::cout << "[Logs]" << std::endl;
 
+	Interpolation interpolation;
+	const std::vector<double> flat;
+	// every bar, segment and peak of a frame goes into one array drawn with a single call,
+	// clearing keeps the storage, which starts out large enough for a bar and a peak
+	// on every pixel column
+	sf::VertexArray quads(sf::Quads, 2 * 4 * WIDTH);
+	// the array is uploaded to a vertex buffer where only changed quads are sent,
+	// or drawn directly where vertex buffers are not available
+	QuadStream stream;
+	std::cout << "Rendering: " << (stream.streaming() ? "Vertex Buffer" : "Vertex Array") << std::endl;
+
 	// the rendering loop
 	while (window->isOpen())
 	{
+		// nothing below reads the shared settings, only this copy
+		const RenderSettings view = renderSettings();
 
 		// clear the window with black color
-		if (borderless) {
+		if (view.borderless) {
 			window->clear(sf::Color::Transparent);
 		}
 		else {
 			window->clear(sf::Color::Black);
 		}
 
-		// protect access to variables of external threads
-		mutex.lock();
+		// newest complete spectrum, the analysis thread never waits for this one
+		const SpectrumFrame& frame = spectrum.read();
+		const std::vector<double>& frequencies = frame.frequencies;
+		const std::vector<double>& peaks = frame.peaks;
 
 		// draw everything here...
 		size_t size = frequencies.size();
-		std::vector<double> inter_f = std::vector<double>();
-		if (inter && size > 2) {
-			for (double i = 0; i <= size - 1; i += (double)size / WIDTH) {
-				inter_f.push_back(interpolate(i));
-			}
+		const int mode = view.inter;
+		const std::vector<double>& inter_f = mode != noInterpolation && size > 2
+			? interpolation.sample(frame, (size - 1) * WIDTH / size + 1, (double)size / WIDTH, mode)
+			: flat;
+		if (inter_f.size() > 0) {
 			size = inter_f.size();
 		}
 		double max = 1;
+		quads.clear();
 		for (int i = 0; i < size; i++) {
 			double magnitude;
 			if (size == 0) magnitude = 0;
-			else magnitude = inter && inter_f.size() > 1 ? inter_f[i] : frequencies[i];
-			double peak = delayedPeaks && !inter ? peaks[i] : 0;
-			sf::RectangleShape rectangle = sf::RectangleShape();
-			if (magnitude > max && (double)i / bars >= 0.15) {
+			else magnitude = mode != noInterpolation && inter_f.size() > 1 ? inter_f[i] : frequencies[i];
+			double peak = view.delayedPeaks && mode == noInterpolation ? peaks[i] : 0;
+			if (magnitude > max && (double)i / view.bars >= 0.15) {
 				max = magnitude;
 			}
 			if (magnitude < HEIGHT * 0.0083) {
@@ -236,7 +293,7 @@ void renderingThread(sf::RenderWindow* window)
 			else if (magnitude > HEIGHT * 0.86) {
 				magnitude = HEIGHT * 0.86;
 			}
-			if (delayedPeaks) {
+			if (view.delayedPeaks) {
 				if (peak < HEIGHT * 0.0083) {
 					peak = HEIGHT * 0.0083;
 				}
@@ -247,51 +304,53 @@ void renderingThread(sf::RenderWindow* window)
 			double margin_x = WIDTH * 0.035;
 			double margin_y = HEIGHT * 0.07;
 			double barWidth = (WIDTH - 2 * margin_x) / size;
-			double shader = shadingRatio * (1 - magnitude / (HEIGHT * 0.86));
+			double shader = view.shadingRatio * (1 - magnitude / (HEIGHT * 0.86));
 			if (shader > 1.0) { shader = 1; }
 			sf::Color colour;
-			colour = gradient[(int)floor(colourCounter + colourOffset * (1 - magnitude / (HEIGHT * 0.86))) % (256 * 6)];
+			colour = gradient[(int)floor(colourCounter + view.colourOffset * (1 - magnitude / (HEIGHT * 0.86))) % (256 * 6)];
 			colour.r -= colour.r * shader;
 			colour.g -= colour.g * shader;
 			colour.b -= colour.b * shader;
-			rectangle.setFillColor(colour);
-			if (classic) {
-				double division = HEIGHT * 0.86 / divisions;
+			const double gap = mode != noInterpolation ? 1 : view.gapRatio;
+			const float width = barWidth * gap;
+			const float left = i * barWidth + margin_x + ((1 - gap) * barWidth / size / 2);
+			if (view.classic) {
+				double division = HEIGHT * 0.86 / view.divisions;
 				int height = floor(magnitude / division);
-				rectangle.setSize(sf::Vector2f(barWidth * (inter ? 1 : gapRatio), 0 - (HEIGHT * 0.86 / divisions) * 0.8));
+				const float segment = 0 - (HEIGHT * 0.86 / view.divisions) * 0.8;
 				for (int j = 0; j < height; j++) {
-					rectangle.setPosition(i * barWidth + margin_x + ((1 - (inter ? 1 : gapRatio)) * barWidth / size / 2), HEIGHT - margin_y - j * division);
-					window->draw(rectangle);
+					appendQuad(quads, left, HEIGHT - margin_y - j * division, width, segment, colour);
 				}
-				if (delayedPeaks) {
+				if (view.delayedPeaks) {
 					int peakHeight = floor(peak / division);
-					if (peakHeight >= divisions) peakHeight = divisions - 1;
-					rectangle.setFillColor(sf::Color::White);
-					rectangle.setPosition(i * barWidth + margin_x + ((1 - (inter ? 1 : gapRatio)) * barWidth / size / 2), HEIGHT - margin_y - peakHeight * division);
-					window->draw(rectangle);
+					if (peakHeight >= view.divisions) peakHeight = view.divisions - 1;
+					appendQuad(quads, left, HEIGHT - margin_y - peakHeight * division, width, segment, sf::Color::White);
 				}
 			}
 			else {
-				rectangle.setSize(sf::Vector2f(barWidth * (inter ? 1 : gapRatio), -magnitude));
-				rectangle.setPosition(i * barWidth + margin_x + ((1 - (inter ? 1 : gapRatio)) * barWidth / size / 2), HEIGHT - margin_y);
-				window->draw(rectangle);
-				if (delayedPeaks) {
-					rectangle.setFillColor(sf::Color::White);
-					rectangle.setSize(sf::Vector2f(barWidth * (inter ? 1 : gapRatio), HEIGHT * 0.0083));
-					rectangle.setPosition(i * barWidth + margin_x + ((1 - (inter ? 1 : gapRatio)) * barWidth / size / 2), HEIGHT - margin_y - peak);
-					window->draw(rectangle);
+				appendQuad(quads, left, HEIGHT - margin_y, width, -magnitude, colour);
+				if (view.delayedPeaks) {
+					appendQuad(quads, left, HEIGHT - margin_y - peak, width, HEIGHT * 0.0083, sf::Color::White);
 				}
 			}
 		}
+		const bool streaming = stream.streaming();
+		stream.draw(*window, quads);
+		if (streaming && !stream.streaming()) {
+			std::cout << "[-] Vertex Buffer Upload Failed, Rendering: Vertex Array" << std::endl;
+		}
 
 		if (colourCounter >= 256.0 * 6.0)
 		{
 			colourCounter = 0;
 		}
 		else {
-			colourCounter += colourChange;
+			colourCounter += view.colourChange;
 		}
 
+		// the scaling settings are shared with the other threads
+		mutex.lock();
+
 		if (autoScale && (max > 5 || max > HEIGHT * 0.85)) {
 			double ratio = 1.0 / autoScaleCycles;
 			averageMax = max * ratio + averageMax * (1 - ratio);
@@ -347,6 +406,13 @@ void loadSettings() {
 		file >> classic;
 		file >> divisions;
 		file >> inter;
+		file >> windowSize;
+		file >> hopSize;
+		file >> spacing;
+		file >> sampleRate;
+		file >> decimation;
+		file >> windowType;
+		file >> peakHold;
 		file.close();
 		std::cout << "Settings Loaded" << std::endl;
 	}
@@ -377,7 +443,14 @@ void saveSettings() {
 	file << decaySmoothing << std::endl;
 	file << classic << std::endl;
 	file << divisions << std::endl;
-	file << inter;
+	file << inter << std::endl;
+	file << windowSize << std::endl;
+	file << hopSize << std::endl;
+	file << spacing << std::endl;
+	file << sampleRate << std::endl;
+	file << decimation << std::endl;
+	file << windowType << std::endl;
+	file << peakHold;
 	file.close();
 	std::cout << "Settings Saved" << std::endl;
 }
@@ -409,8 +482,6 @@ int main() {
 		gradient[i + 256 * 5] = sf::Color(255, 0, 255 - i);
 	}
 
-	frequencies = std::vector<double>();
-
 	// create the window (remember: it's safer to create it in the main thread due to OS limitations)
 	sf::RenderWindow* window = new sf::RenderWindow(sf::VideoMode(WIDTH, HEIGHT), "Audio Visualizer", sf::Style::Default);
 	window->setVerticalSyncEnabled(false);
@@ -447,7 +518,10 @@ int main() {
 		return -1;
 	}
 
-	Recorder recorder;
+	// over a second of samples at 48 kHz between the audio thread and the analysis thread
+	RingBuffer<sf::Int16> samples(65536);
+	Analyser analyser(samples, spectrum);
+	Recorder recorder(samples);
 
 	if (!recorder.setDevice(inputDevice))
 	{
@@ -455,7 +529,8 @@ int main() {
 		return -1;
 	}
 
-	recorder.start();
+	analyser.start();
+	recorder.start(sampleRate);
 
 	// the event/logic/whatever loop
 	while (window->isOpen())
@@ -470,8 +545,11 @@ int main() {
 			}
 			else if (event.type == sf::Event::MouseButtonPressed) {
 				HWND hwnd = window->getSystemHandle();
+				mutex.lock();
 				borderless = !borderless;
-				if (borderless) {
+				const bool frameless = borderless;
+				mutex.unlock();
+				if (frameless) {
 					SetWindowLongPtr(hwnd, GWL_STYLE, WS_SYSMENU);
 					SetWindowPos(hwnd, HWND_TOPMOST, window->getPosition().x, window->getPosition().y + 39, window->getSize().x + 16, window->getSize().y, SWP_SHOWWINDOW);
 				}
@@ -481,6 +559,8 @@ int main() {
 				}
 			}
 			else if (event.type == sf::Event::KeyPressed) {
+				// rate to restart capture at once the lock is released, 0 to keep it running
+				uint32_t restartRate = 0;
 				// protect access to variables of external threads
 				mutex.lock();
 				if ((sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::RShift)) && (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) || sf::Keyboard::isKeyPressed(sf::Keyboard::RControl)) && (sf::Keyboard::isKeyPressed(sf::Keyboard::LAlt) || sf::Keyboard::isKeyPressed(sf::Keyboard::RAlt))) {
@@ -553,6 +633,27 @@ int main() {
 							std::cout << "[-] Peak Decay Speed: " << peakDecay << std::endl;
 						}
 						break;
+					case sf::Keyboard::PageUp:
+						if (peakHold < 200) {
+							peakHold++;
+							std::cout << "[+] Peak Hold: " << peakHold << std::endl;
+						}
+						break;
+					case sf::Keyboard::PageDown:
+						if (peakHold > 0) {
+							peakHold--;
+							std::cout << "[-] Peak Hold: " << peakHold << std::endl;
+						}
+						break;
+					case sf::Keyboard::Tab:
+						decimation = !decimation;
+						if (decimation) {
+							std::cout << "[+] Decimation: Enabled" << std::endl;
+						}
+						else {
+							std::cout << "[-] Decimation: Disabled" << std::endl;
+						}
+						break;
 					case sf::Keyboard::BackSpace:
 						decaySmoothing = !decaySmoothing;
 						if (decaySmoothing) {
@@ -565,17 +666,28 @@ int main() {
 				}
 				else if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) || sf::Keyboard::isKeyPressed(sf::Keyboard::RControl)) {
 					switch (event.key.code) {
+					case sf::Keyboard::Tab: {
+						// restart capture at the next common rate, lower rates cost proportionally less
+						const uint32_t rates[] = { 8000, 16000, 22050, 32000, 44100, 48000 };
+						const size_t count = sizeof(rates) / sizeof(rates[0]);
+						size_t next = 0;
+						while (next < count && rates[next] <= sampleRate) {
+							next++;
+						}
+						sampleRate = rates[next % count];
+						restartRate = sampleRate;
+						std::cout << "[=] Sample Rate: " << sampleRate << std::endl;
+						break;
+					}
 					case sf::Keyboard::Up:
-						if (bars < 2048 && !(inter && bars >= 50)) {
+						if (bars < 2048 && !(inter && bars >= interpolationBars)) {
 							bars++;
-							frequencies.clear();
 							std::cout << "[+] Bars: " << bars << std::endl;
 						}
 						break;
 					case sf::Keyboard::Down:
 						if (bars > 1) {
 							bars--;
-							frequencies.clear();
 							std::cout << "[-] Bars: " << bars << std::endl;
 						}
 						break;
@@ -640,22 +752,18 @@ int main() {
 						}
 						break;
 					case sf::Keyboard::BackSpace:
-						inter = !inter;
+						inter = (inter + 1) % interpolationCount;
 						if (inter) {
-							if (bars > 50) {
-								bars = 50;
-								frequencies.clear();
+							if (bars > interpolationBars) {
+								bars = interpolationBars;
 								std::cout << "[=] Bars: " << bars << std::endl;
 							}
 							if (delayedPeaks) {
 								delayedPeaks = false;
 								std::cout << "[-] Delayed Peaks: Disabled" << std::endl;
 							}
-							std::cout << "[+] Interpolation Mode Enabled" << std::endl;
-						}
-						else {
-							std::cout << "[-] Interpolation Mode Disabled" << std::endl;
 						}
+						std::cout << "[=] Bar Interpolation: " << interpolationName(inter) << std::endl;
 						break;
 					}
 				}
@@ -705,15 +813,62 @@ int main() {
 							}
 						}
 						break;
+					case sf::Keyboard::PageUp:
+						// below a millisecond the hop doubles and halves
+						if (hopSize < sampleRate / 1000) {
+							hopSize = std::min<uint16_t>(hopSize * 2, sampleRate / 1000);
+							std::cout << "[+] Analysis Hop: " << hopSize << std::endl;
+						}
+						else if (hopSize < sampleRate / 10) {
+							hopSize += sampleRate / 1000;
+							std::cout << "[+] Analysis Hop: " << hopSize << std::endl;
+						}
+						break;
+					case sf::Keyboard::PageDown:
+						if (hopSize > sampleRate / 1000) {
+							hopSize -= sampleRate / 1000;
+							std::cout << "[-] Analysis Hop: " << hopSize << std::endl;
+						}
+						else if (hopSize > 8) {
+							hopSize /= 2;
+							std::cout << "[-] Analysis Hop: " << hopSize << std::endl;
+						}
+						break;
+					case sf::Keyboard::Home:
+						if (windowSize < 32768) {
+							windowSize *= 2;
+							std::cout << "[+] Analysis Window: " << windowSize << std::endl;
+						}
+						break;
+					case sf::Keyboard::End:
+						if (windowSize > 1024) {
+							windowSize /= 2;
+							std::cout << "[-] Analysis Window: " << windowSize << std::endl;
+						}
+						break;
+					case sf::Keyboard::Tab:
+						spacing = (spacing + 1) % spacingCount;
+						std::cout << "[=] Band Spacing: " << spacingName(spacing) << std::endl;
+						break;
+					case sf::Keyboard::Insert:
+						windowType = (windowType + 1) % windowCount;
+						std::cout << "[=] Window Function: " << windowName(windowType) << std::endl;
+						break;
 					}
 				}
 
 				mutex.unlock();
+				// stopping joins the capture thread, the other threads keep their settings meanwhile
+				if (restartRate) {
+					recorder.stop();
+					recorder.start(restartRate);
+				}
 			}
 		}
 	}
 
 	recorder.stop();
+	analyser.stop();
 	saveSettings();
 
 	return 0;
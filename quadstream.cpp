@@ -0,0 +1,94 @@
+// quadstream.cpp - change detection and partial uploads of the frame geometry
+
+#include "quadstream.h"
+#include <algorithm>
+#include <cstring>
+
+// unchanged quads between two changed ones that are sent along rather than splitting the upload
+static const size_t mergeGap = 16;
+// uploads per frame, beyond that everything from the first change on goes at once
+static const size_t maxUploads = 8;
+
+QuadStream::QuadStream() : buffer(sf::Quads, sf::VertexBuffer::Stream), available(sf::VertexBuffer::isAvailable()), sent(0) {
+	runs.reserve(maxUploads + 1);
+}
+
+bool QuadStream::upload(const sf::VertexArray& quads, size_t first, size_t last) {
+	const sf::Vertex* const vertices = &quads[0];
+	if (!buffer.update(vertices + first, last - first, (unsigned int)first)) {
+		return false;
+	}
+	if (shown.size() < last) {
+		shown.resize(last);
+	}
+	std::copy(vertices + first, vertices + last, shown.begin() + first);
+	sent += last - first;
+	return true;
+}
+
+void QuadStream::draw(sf::RenderTarget& target, const sf::VertexArray& quads) {
+	const size_t count = quads.getVertexCount();
+	sent = 0;
+	if (available && count > buffer.getVertexCount()) {
+		// a new buffer holds nothing defined, so nothing of the old copy is valid either
+		available = buffer.create(std::max(count, 2 * buffer.getVertexCount()));
+		shown.clear();
+	}
+	if (available && count > 0) {
+		const sf::Vertex* const vertices = &quads[0];
+		// the buffer is only known to match the copy over its length, past that
+		// every vertex is sent
+		const size_t known = std::min(count, shown.size());
+		runs.clear();
+		size_t i = 0;
+		while (i < known) {
+			size_t length = std::min<size_t>(4, known - i);
+			if (std::memcmp(vertices + i, shown.data() + i, length * sizeof(sf::Vertex)) == 0) {
+				i += length;
+				continue;
+			}
+			const size_t first = i;
+			size_t last = i + length;
+			size_t unchanged = 0;
+			for (i = last; i < known && unchanged <= mergeGap; i += length) {
+				length = std::min<size_t>(4, known - i);
+				if (std::memcmp(vertices + i, shown.data() + i, length * sizeof(sf::Vertex)) == 0) {
+					unchanged++;
+				}
+				else {
+					last = i + length;
+					unchanged = 0;
+				}
+			}
+			runs.push_back(Run(first, last));
+			if (runs.size() > maxUploads) {
+				break;
+			}
+		}
+		if (known < count) {
+			if (!runs.empty() && known - runs.back().second <= 4 * mergeGap) {
+				runs.back().second = count;
+			}
+			else {
+				runs.push_back(Run(known, count));
+			}
+		}
+		if (runs.size() > maxUploads) {
+			// too scattered, one upload over the whole changed span
+			const size_t first = runs.front().first;
+			runs.clear();
+			runs.push_back(Run(first, count));
+		}
+		for (size_t r = 0; r < runs.size() && available; r++) {
+			available = upload(quads, runs[r].first, runs[r].second);
+		}
+	}
+	if (available) {
+		if (count > 0) {
+			target.draw(buffer, 0, count);
+		}
+	}
+	else {
+		target.draw(quads);
+	}
+}
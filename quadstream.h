@@ -0,0 +1,49 @@
+// quadstream.h - frame geometry kept on the GPU, only the vertices that changed are uploaded
+
+#ifndef AUDIOANALYSER_QUADSTREAM_H
+#define AUDIOANALYSER_QUADSTREAM_H
+
+#include "SFML/Graphics.hpp"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// the quads of the last frame stay in a stream vertex buffer next to a copy in memory,
+// each frame is compared against that copy a quad at a time and only the runs that differ
+// are sent, nearby runs merged so a frame costs a handful of uploads at most; needs
+// nothing beyond vertex buffer objects, which any OpenGL 1.5 driver including Mesa's
+// software rasterizer provides, without them or after a failed upload the quads are
+// drawn straight from memory as before
+class QuadStream
+{
+public:
+	// must be created on the thread whose context is active for drawing
+	QuadStream();
+
+	QuadStream(const QuadStream&) = delete;
+	QuadStream& operator=(const QuadStream&) = delete;
+
+	// draw the quads to target, updating the buffer from the previous frame's quads
+	void draw(sf::RenderTarget& target, const sf::VertexArray& quads);
+
+	// whether the vertex buffer is in use rather than the fallback
+	bool streaming() const { return available; }
+
+	// vertices sent to the buffer by the last draw
+	size_t uploaded() const { return sent; }
+
+private:
+	// send vertices [first, last) and keep the copy in step, false on failure
+	bool upload(const sf::VertexArray& quads, size_t first, size_t last);
+
+	sf::VertexBuffer buffer;
+	// what the buffer holds, vertex for vertex
+	std::vector<sf::Vertex> shown;
+	// changed vertex ranges [first, second) of the frame being drawn
+	typedef std::pair<size_t, size_t> Run;
+	std::vector<Run> runs;
+	bool available;
+	size_t sent;
+};
+
+#endif
@@ -0,0 +1,82 @@
+// ringbuffer.h - lock-free single-producer single-consumer queue of samples
+
+#ifndef AUDIOANALYSER_RINGBUFFER_H
+#define AUDIOANALYSER_RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// fixed capacity, rounded up to a power of two, allocated once at construction;
+// one thread pushes and one other thread pops, neither ever waits
+template <class T>
+class RingBuffer
+{
+public:
+	explicit RingBuffer(size_t capacity) : mask(0), head(0), tail(0) {
+		size_t size = 1;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		values.resize(size);
+		mask = size - 1;
+	}
+
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer& operator=(const RingBuffer&) = delete;
+
+	size_t capacity() const { return mask + 1; }
+
+	// producer side: append up to count values, returns how many fit
+	size_t push(const T* source, size_t count) {
+		const size_t write = head.load(std::memory_order_relaxed);
+		const size_t free = capacity() - (write - tail.load(std::memory_order_acquire));
+		if (count > free) {
+			count = free;
+		}
+		for (size_t i = 0; i < count; i++) {
+			values[(write + i) & mask] = source[i];
+		}
+		head.store(write + count, std::memory_order_release);
+		return count;
+	}
+
+	// consumer side: values ready to be popped
+	size_t available() const {
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+	}
+
+	// consumer side: take up to count values, returns how many were taken
+	size_t pop(T* target, size_t count) {
+		const size_t read = tail.load(std::memory_order_relaxed);
+		const size_t ready = head.load(std::memory_order_acquire) - read;
+		if (count > ready) {
+			count = ready;
+		}
+		for (size_t i = 0; i < count; i++) {
+			target[i] = values[(read + i) & mask];
+		}
+		tail.store(read + count, std::memory_order_release);
+		return count;
+	}
+
+	// consumer side: drop up to count values, returns how many were dropped
+	size_t discard(size_t count) {
+		const size_t read = tail.load(std::memory_order_relaxed);
+		const size_t ready = head.load(std::memory_order_acquire) - read;
+		if (count > ready) {
+			count = ready;
+		}
+		tail.store(read + count, std::memory_order_release);
+		return count;
+	}
+
+private:
+	std::vector<T> values;
+	size_t mask;
+	// running write and read positions, only their difference matters
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+};
+
+#endif
@@ -0,0 +1,22 @@
+// settings.cpp - defaults of the shared settings, settings.ini overrides them at startup
+
+#include "settings.h"
+#include "bandmap.h"
+#include "windowtable.h"
+
+std::mutex mutex;
+uint32_t windowSize = 16384;
+uint16_t hopSize = frameSize;
+std::atomic<uint32_t> captureRate(defaultRate);
+uint16_t bars = 30;
+uint16_t maxFrequency = 2500;
+uint16_t peakDecay = 12;
+uint16_t peakHold = 0;
+double scale1 = 285.0;
+double scale2 = 2.2e-9;
+double smoothing = 0.75;
+bool delayedPeaks = true;
+bool decaySmoothing = true;
+int spacing = linearSpacing;
+bool decimation = true;
+int windowType = hannWindow;
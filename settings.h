@@ -0,0 +1,36 @@
+// settings.h - settings shared between the window thread and the analysis thread
+
+#ifndef AUDIOANALYSER_SETTINGS_H
+#define AUDIOANALYSER_SETTINGS_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+const uint32_t processingInterval = 15;
+const uint32_t defaultRate = 44100;
+// samples per processing interval, the frame length the level scales were tuned for
+const uint32_t frameSize = defaultRate * processingInterval / 1000;
+
+// guards the settings, the analysis thread only ever tries to take it
+extern std::mutex mutex;
+// samples in each analysed frame, and between consecutive frames
+extern uint32_t windowSize;
+extern uint16_t hopSize;
+// the rate the running capture reports, which every frequency table is built from
+extern std::atomic<uint32_t> captureRate;
+extern uint16_t bars;
+extern uint16_t maxFrequency;
+extern uint16_t peakDecay;
+// frames a peak stays up before it starts to fall
+extern uint16_t peakHold;
+extern double scale1;
+extern double scale2;
+extern double smoothing;
+extern bool delayedPeaks;
+extern bool decaySmoothing;
+extern int spacing;
+extern bool decimation;
+extern int windowType;
+
+#endif
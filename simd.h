@@ -0,0 +1,15 @@
+// simd.h - whether the compiler may emit SSE2 without a runtime check, for the main-side kernels
+
+#ifndef AUDIOANALYSER_SIMD_H
+#define AUDIOANALYSER_SIMD_H
+
+// x64 always has SSE2, 32-bit x86 only when built for it; unlike FFT_SIMD in fftkernels.h,
+// which marks kernels picked at runtime, code under SIMD_SSE2 runs unguarded
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define SIMD_SSE2 0
+#endif
+
+#endif
@@ -0,0 +1,143 @@
+// slidingdft.h - recursive update of the lowest bins of a windowed DFT as samples slide through
+
+#ifndef AUDIOANALYSER_SLIDINGDFT_H
+#define AUDIOANALYSER_SLIDINGDFT_H
+
+#include "buffer.h"
+#include "complex.h"
+#include <cmath>
+#include <cstddef>
+
+// tracks bins [0, bins) of the DFT of the last length samples as they slide by a fixed
+// step; sliding by one sample is X[k] = (X[k] + newest - oldest) * w, w = exp(2 pi i k / length),
+// so a step of h samples is X[k] = w^h X[k] + w y, where y sums the differences rotated
+// by powers of w; y comes from a Goertzel recursion, one multiply and two adds per sample and bin,
+// rounding errors accumulate, so the spectrum is reset from a full transform now and then
+template <class T>
+class SlidingDFT
+{
+public:
+	SlidingDFT() : length(0), count(0), step(0), slid(0), valid(false) {}
+
+	SlidingDFT(const SlidingDFT&) = delete;
+	SlidingDFT& operator=(const SlidingDFT&) = delete;
+
+	// track bins [0, bins) of a length sample window sliding hop samples at a time,
+	// tracking restarts when any of them changes, returns true if storage had to be allocated
+	bool resize(size_t newLength, size_t bins, size_t hop) {
+		if (newLength == length && bins == count && hop == step) {
+			return false;
+		}
+		bool resized = false;
+		resized |= real.resize(bins);
+		resized |= imag.resize(bins);
+		resized |= cosine.resize(bins);
+		resized |= sine.resize(bins);
+		resized |= cosineStep.resize(bins);
+		resized |= sineStep.resize(bins);
+		length = newLength;
+		count = bins;
+		step = hop;
+		const double pi = 3.14159265358979323846;
+		for (size_t k = 0; k < bins; k++) {
+			const double phase = 2. * pi * k / length;
+			// reduced before scaling, so w^h stays accurate for long steps
+			const double stepPhase = 2. * pi * (double)((k * step) % length) / length;
+			cosine[k] = cos(phase);
+			sine[k] = sin(phase);
+			cosineStep[k] = cos(stepPhase);
+			sineStep[k] = sin(stepPhase);
+		}
+		valid = false;
+		return resized;
+	}
+
+	size_t bins() const { return count; }
+	size_t hop() const { return step; }
+
+	// whether the bins follow the signal, and how many samples slid since the last reset
+	bool tracking() const { return valid; }
+	size_t drift() const { return slid; }
+
+	// stop tracking until the next reset, for when samples pass by unseen
+	void invalidate() { valid = false; }
+
+	// restart from bins [0, bins) of a spectrum of the current window computed in full
+	void reset(const tcomplex<T>* const spectrum) {
+		for (size_t k = 0; k < count; k++) {
+			real[k] = spectrum[k].re();
+			imag[k] = spectrum[k].im();
+		}
+		slid = 0;
+		valid = true;
+	}
+
+	// slide by one hop, where delta[n] is the sample entering the window minus the one leaving it;
+	// bins run a block at a time so the recursions of neighbouring bins are independent
+	void slide(const double* const delta) {
+		const size_t block = 8;
+		size_t k = 0;
+		for (; k + block <= count; k += block) {
+			double s1[block] = {}, s2[block] = {}, twice[block];
+			for (size_t j = 0; j < block; j++) {
+				twice[j] = 2. * cosine[k + j];
+			}
+			for (size_t n = 0; n < step; n++) {
+				const double d = delta[n];
+				for (size_t j = 0; j < block; j++) {
+					const double s0 = d + twice[j] * s1[j] - s2[j];
+					s2[j] = s1[j];
+					s1[j] = s0;
+				}
+			}
+			for (size_t j = 0; j < block; j++) {
+				rotate(k + j, s1[j], s2[j]);
+			}
+		}
+		for (; k < count; k++) {
+			double s1 = 0, s2 = 0;
+			const double twice = 2. * cosine[k];
+			for (size_t n = 0; n < step; n++) {
+				const double s0 = delta[n] + twice * s1 - s2;
+				s2 = s1;
+				s1 = s0;
+			}
+			rotate(k, s1, s2);
+		}
+		slid += step;
+	}
+
+	// write bins [0, bins) in the layout of the forward transform
+	void read(tcomplex<T>* const spectrum) const {
+		for (size_t k = 0; k < count; k++) {
+			spectrum[k] = tcomplex<T>(T(real[k]), T(imag[k]));
+		}
+	}
+
+private:
+	// X = w^h X + w y with y = s1 - conj(w) s2 from the last two Goertzel states
+	void rotate(size_t k, double s1, double s2) {
+		const double c = cosine[k], s = sine[k];
+		const double yRe = s1 - c * s2;
+		const double yIm = s * s2;
+		const double re = real[k], im = imag[k];
+		real[k] = cosineStep[k] * re - sineStep[k] * im + c * yRe - s * yIm;
+		imag[k] = sineStep[k] * re + cosineStep[k] * im + s * yRe + c * yIm;
+	}
+
+	size_t length;
+	size_t count;
+	size_t step;
+	size_t slid;
+	bool valid;
+	// running bins kept in double whatever T is, the rotation w of each bin
+	// over one sample and its power w^h over one hop
+	AlignedBuffer<double> real;
+	AlignedBuffer<double> imag;
+	AlignedBuffer<double> cosine;
+	AlignedBuffer<double> sine;
+	AlignedBuffer<double> cosineStep;
+	AlignedBuffer<double> sineStep;
+};
+
+#endif
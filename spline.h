@@ -94,12 +94,16 @@ namespace
 			bd_type m_left, m_right;
 			double  m_left_value, m_right_value;
 			bool    m_force_linear_extrapolation;
+			// knots at m_x0 + i*m_h, set by set_uniform_points()
+			bool    m_uniform;
+			double  m_x0, m_h;
 
 		public:
 			// set default boundary condition to be zero curvature at both ends
 			spline() : m_left(second_deriv), m_right(second_deriv),
 				m_left_value(0.0), m_right_value(0.0),
-				m_force_linear_extrapolation(false)
+				m_force_linear_extrapolation(false),
+				m_uniform(false), m_x0(0.0), m_h(1.0)
 			{
 				;
 			}
@@ -110,7 +114,14 @@ namespace
 				bool force_linear_extrapolation = false);
 			void set_points(const std::vector<double>& x,
 				const std::vector<double>& y, bool cubic_spline = true);
+			// cubic spline through y[i] at x0+i*h, h > 0, the tridiagonal system
+			// is solved in place in the coefficient vectors, so once they have
+			// grown to n no memory is allocated
+			void set_uniform_points(double x0, double h, const double* y, size_t n);
 			double operator() (double x) const;
+			// evaluate at the n points x0, x0+dx, ..., x0+(n-1)*dx for dx > 0,
+			// walking the segments once instead of searching for every point
+			void evaluate(double x0, double dx, size_t n, double* y) const;
 		};
 
 
@@ -287,6 +298,7 @@ namespace
 		{
 			assert(x.size() == y.size());
 			assert(x.size() > 2);
+			m_uniform = false;
 			m_x = x;
 			m_y = y;
 			int   n = x.size();
@@ -378,13 +390,99 @@ namespace
 				m_b[n - 1] = 0.0;
 		}
 
+		void spline::set_uniform_points(double x0, double h, const double* y, size_t n)
+		{
+			assert(n > 2);
+			assert(h > 0);
+			m_uniform = true;
+			m_x0 = x0;
+			m_h = h;
+			m_x.resize(n);
+			for (size_t i = 0; i < n; i++) m_x[i] = x0 + i * h;
+			m_y.assign(y, y + n);
+			m_a.resize(n);
+			m_b.resize(n);
+			m_c.resize(n);
+
+			// same system as set_points() with all x[i+1]-x[i] = h:
+			// h/3 b[i-1] + 4h/3 b[i] + h/3 b[i+1] = (y[i+1]-2y[i]+y[i-1])/h,
+			// solved by the Thomas algorithm, m_c holds the eliminated upper
+			// diagonal and m_b the right hand side, then the solution
+			double diag, upper;
+			if (m_left == spline::second_deriv) {
+				diag = 2.0;
+				upper = 0.0;
+				m_b[0] = m_left_value;
+			}
+			else if (m_left == spline::first_deriv) {
+				diag = 2.0 * h;
+				upper = h;
+				m_b[0] = 3.0 * ((y[1] - y[0]) / h - m_left_value);
+			}
+			else {
+				assert(false);
+				diag = 1.0;
+				upper = 0.0;
+			}
+			m_c[0] = upper / diag;
+			m_b[0] /= diag;
+			const double side = h / 3.0;
+			for (size_t i = 1; i < n - 1; i++) {
+				double pivot = 4.0 * side - side * m_c[i - 1];
+				m_c[i] = side / pivot;
+				m_b[i] = ((y[i + 1] - 2.0 * y[i] + y[i - 1]) / h - side * m_b[i - 1]) / pivot;
+			}
+			double lower, rhs;
+			if (m_right == spline::second_deriv) {
+				lower = 0.0;
+				diag = 2.0;
+				rhs = m_right_value;
+			}
+			else if (m_right == spline::first_deriv) {
+				lower = h;
+				diag = 2.0 * h;
+				rhs = 3.0 * (m_right_value - (y[n - 1] - y[n - 2]) / h);
+			}
+			else {
+				assert(false);
+				lower = 0.0;
+				diag = 1.0;
+				rhs = 0.0;
+			}
+			m_b[n - 1] = (rhs - lower * m_b[n - 2]) / (diag - lower * m_c[n - 2]);
+			for (size_t i = n - 1; i-- > 0;) {
+				m_b[i] -= m_c[i] * m_b[i + 1];
+			}
+
+			for (size_t i = 0; i < n - 1; i++) {
+				m_a[i] = 1.0 / 3.0 * (m_b[i + 1] - m_b[i]) / h;
+				m_c[i] = (y[i + 1] - y[i]) / h - 1.0 / 3.0 * (2.0 * m_b[i] + m_b[i + 1]) * h;
+			}
+
+			m_b0 = (m_force_linear_extrapolation == false) ? m_b[0] : 0.0;
+			m_c0 = m_c[0];
+			m_a[n - 1] = 0.0;
+			m_c[n - 1] = 3.0 * m_a[n - 2] * h * h + 2.0 * m_b[n - 2] * h + m_c[n - 2];
+			if (m_force_linear_extrapolation == true)
+				m_b[n - 1] = 0.0;
+		}
+
 		double spline::operator() (double x) const
 		{
 			size_t n = m_x.size();
 			// find the closest point m_x[idx] < x, idx=0 even if x<m_x[0]
-			std::vector<double>::const_iterator it;
-			it = std::lower_bound(m_x.begin(), m_x.end(), x);
-			int idx = max(int(it - m_x.begin()) - 1, 0);
+			int idx;
+			if (m_uniform) {
+				// any segment containing x gives the same value, so the knot
+				// index can be computed instead of searched for
+				double pos = (x - m_x0) / m_h;
+				idx = pos <= 0.0 ? 0 : pos >= n - 1 ? int(n - 1) : min(int(pos), int(n - 2));
+			}
+			else {
+				std::vector<double>::const_iterator it;
+				it = std::lower_bound(m_x.begin(), m_x.end(), x);
+				idx = max(int(it - m_x.begin()) - 1, 0);
+			}
 
 			double h = x - m_x[idx];
 			double interpol;
@@ -403,6 +501,35 @@ namespace
 			return interpol;
 		}
 
+		void spline::evaluate(double x0, double dx, size_t n, double* y) const
+		{
+			assert(dx > 0);
+			size_t size = m_x.size();
+			size_t idx = 0;
+			for (size_t k = 0; k < n; k++) {
+				double x = x0 + k * dx;
+				if (m_uniform) {
+					// segment by index arithmetic, clamped to the last one
+					double pos = (x - m_x0) / m_h;
+					idx = pos <= 0.0 ? 0 : pos >= size - 1 ? size - 1 : min(size_t(pos), size - 2);
+				}
+				else {
+					// same segment as operator(): the last m_x[idx] < x, idx=0 even if x<m_x[0]
+					while (idx + 1 < size && m_x[idx + 1] < x) idx++;
+				}
+				double h = x - m_x[idx];
+				if (x < m_x[0]) {
+					y[k] = (m_b0 * h + m_c0) * h + m_y[0];
+				}
+				else if (x > m_x[size - 1]) {
+					y[k] = (m_b[size - 1] * h + m_c[size - 1]) * h + m_y[size - 1];
+				}
+				else {
+					y[k] = ((m_a[idx] * h + m_b[idx]) * h + m_c[idx]) * h + m_y[idx];
+				}
+			}
+		}
+
 
 	} // namespace tk
 
@@ -0,0 +1,122 @@
+// analysertests.cpp - feeds a few hundred frames of generated audio through the analyser
+// and checks, with the counter from allocations.cpp, that no frame after the buffers are
+// sized touches the heap
+
+#include "tests.h"
+#include "../analyser.h"
+#include "../settings.h"
+#include "../allocations.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifndef COUNT_ALLOCATIONS
+#error the analyser tests need COUNT_ALLOCATIONS to count allocations
+#endif
+
+// one setup of the analysis, applied under the lock like the window thread does
+struct Setup
+{
+	const char* name;
+	uint32_t window;
+	uint16_t hop;
+	uint16_t bars;
+	int spacing;
+	bool decimation;
+	int windowType;
+	uint16_t peakHold;
+	// bar count switched to halfway, 0 keeps it
+	uint16_t laterBars;
+};
+
+static const Setup setups[] = {
+	{ "defaults", 16384, frameSize, 30, linearSpacing, true, hannWindow, 0, 0 },
+	// a short hop takes the recursive update instead of a transform per frame
+	{ "short hop", 16384, 64, 30, linearSpacing, true, hannWindow, 0, 0 },
+	// Kaiser is not a cosine sum, so the window is always applied before the transform
+	{ "no decimation, Kaiser", 4096, frameSize, 64, melSpacing, false, kaiserWindow, 8, 0 },
+	{ "log spacing, bar change", 8192, frameSize, 200, logarithmicSpacing, true, blackmanHarrisWindow, 4, 75 },
+};
+
+static const unsigned int framesPerSetup = 100;
+
+static void apply(const Setup& setup, uint16_t barCount) {
+	std::lock_guard<std::mutex> lock(mutex);
+	windowSize = setup.window;
+	hopSize = setup.hop;
+	bars = barCount;
+	spacing = setup.spacing;
+	decimation = setup.decimation;
+	windowType = setup.windowType;
+	peakHold = setup.peakHold;
+}
+
+// push one hop of two tones over noise and wait until the analyser has taken it
+static bool feed(RingBuffer<sf::Int16>& samples, Analyser& analyser, size_t hop, size_t& time) {
+	std::vector<sf::Int16> block(hop);
+	for (size_t i = 0; i < hop; i++, time++) {
+		const double t = (double)time / defaultRate;
+		const double tone = 9000 * sin(2 * 3.14159265358979 * 440 * t) + 4000 * sin(2 * 3.14159265358979 * 1870 * t);
+		const double noise = (double)((time * 2654435761u) % 2001) - 1000;
+		block[i] = (sf::Int16)(tone + noise);
+	}
+	const uint64_t before = analyser.frames();
+	if (samples.push(block.data(), hop) != hop) {
+		return false;
+	}
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (analyser.frames() == before) {
+		if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+	return true;
+}
+
+void analyserTests() {
+	for (const Setup& setup : setups) {
+		std::cout << "analyser: " << setup.name << std::endl;
+		apply(setup, setup.bars);
+		RingBuffer<sf::Int16> samples(65536);
+		TripleBuffer<SpectrumFrame> spectrum;
+		Analyser analyser(samples, spectrum);
+
+		// the first frame fills a whole window, later ones a hop each
+		std::vector<sf::Int16> silence(setup.window, 0);
+		samples.push(silence.data(), silence.size());
+		analyser.start();
+
+		size_t time = 0;
+		unsigned int fed = 0;
+		bool finite = true;
+		uint64_t seen = 0;
+		for (unsigned int i = 0; i < framesPerSetup; i++) {
+			if (setup.laterBars && i == framesPerSetup / 2) {
+				apply(setup, setup.laterBars);
+			}
+			if (!feed(samples, analyser, setup.hop, time)) {
+				break;
+			}
+			fed++;
+			const SpectrumFrame& frame = spectrum.read();
+			if (frame.number != seen) {
+				seen = frame.number;
+				for (size_t b = 0; b < frame.frequencies.size(); b++) {
+					finite &= std::isfinite(frame.frequencies[b]) && std::isfinite(frame.peaks[b]);
+				}
+			}
+		}
+		analyser.stop();
+
+		const uint16_t finalBars = setup.laterBars ? setup.laterBars : setup.bars;
+		CHECK(fed == framesPerSetup);
+		CHECK(analyser.steadyFrames() > framesPerSetup / 2);
+		CHECK(analyser.allocatingFrames() == 0);
+		CHECK(finite);
+		CHECK(spectrum.read().frequencies.size() == finalBars);
+	}
+	apply(setups[0], setups[0].bars);
+}
@@ -0,0 +1,78 @@
+// barstatetests.cpp - the SSE2 bar update against the scalar rules on random levels,
+// for bar counts that leave a scalar tail, compared bar for bar every frame
+
+#include "tests.h"
+#include "../barstate.h"
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const size_t barCounts[] = { 1, 2, 3, 5, 7, 13, 30, 1021 };
+static const unsigned int framesPerCase = 200;
+
+// index of the first bar whose value, peak or hold differs, count if none
+static size_t firstDifference(const BarState& a, const BarState& b) {
+	for (size_t i = 0; i < a.size(); i++) {
+		if (std::memcmp(a.values() + i, b.values() + i, sizeof(float)) != 0 ||
+			std::memcmp(a.peaks() + i, b.peaks() + i, sizeof(float)) != 0 ||
+			std::memcmp(a.holds() + i, b.holds() + i, sizeof(float)) != 0) {
+			return i;
+		}
+	}
+	return a.size();
+}
+
+void barStateTests() {
+	std::cout << "bar state: SSE2 against scalar" << std::endl;
+	std::mt19937 random(7);
+	// levels as decibels() leaves them, from below the floor to well above the top,
+	// a quarter rounded to whole numbers so equal levels, values and peaks come up
+	std::uniform_real_distribution<float> level(-100, 700);
+	std::uniform_real_distribution<float> chance(0, 1);
+	for (const size_t bars : barCounts) {
+		for (int peakHold = 0; peakHold < 2; peakHold++) {
+			for (int delayedPeaks = 0; delayedPeaks < 2; delayedPeaks++) {
+				for (int decaySmoothing = 0; decaySmoothing < 2; decaySmoothing++) {
+					BarRules rules;
+					rules.smoothing = 0.75f;
+					rules.decaySmoothing = decaySmoothing != 0;
+					rules.delayedPeaks = delayedPeaks != 0;
+					rules.peakDecay = 12;
+					rules.holdFrames = peakHold ? 6.0f : 0.0f;
+
+					BarState vector, scalar;
+					vector.resize(bars);
+					scalar.resize(bars);
+					std::vector<float> levels(bars);
+					for (size_t i = 0; i < bars; i++) {
+						levels[i] = level(random);
+					}
+					vector.reset(levels.data());
+					scalar.reset(levels.data());
+
+					size_t mismatch = bars;
+					unsigned int frame = 0;
+					for (; frame < framesPerCase && mismatch == bars; frame++) {
+						// now and then a frame of silence, so peaks fall and holds run out
+						const bool silent = chance(random) < 0.1f;
+						for (size_t i = 0; i < bars; i++) {
+							float l = silent ? 0 : level(random);
+							if (chance(random) < 0.25f) {
+								l = (float)(int)l;
+							}
+							levels[i] = l;
+						}
+						vector.update(levels.data(), rules);
+						scalar.updateReference(levels.data(), rules);
+						mismatch = firstDifference(vector, scalar);
+					}
+					if (!CHECK(mismatch == bars)) {
+						std::cout << "  " << bars << " bars, hold " << rules.holdFrames << ", delayed peaks " << rules.delayedPeaks
+							<< ", decay smoothing " << rules.decaySmoothing << ": bar " << mismatch << " differs in frame " << frame << std::endl;
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,152 @@
+// Graphics.hpp - stand-in for the few SFML graphics types QuadStream uses, found ahead of the
+// real header by the tests, so its uploads can be checked without a window or an OpenGL
+// context; the vertex buffer keeps its contents in memory, follows the update rules
+// SFML 2.5 documents and logs every upload
+
+#ifndef AUDIOANALYSER_MOCK_GRAPHICS_HPP
+#define AUDIOANALYSER_MOCK_GRAPHICS_HPP
+
+#include "SFML/Config.hpp"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sf
+{
+
+struct Vector2f
+{
+	Vector2f(float x = 0, float y = 0) : x(x), y(y) {}
+
+	float x;
+	float y;
+};
+
+struct Color
+{
+	Color(Uint8 r = 0, Uint8 g = 0, Uint8 b = 0, Uint8 a = 255) : r(r), g(g), b(b), a(a) {}
+
+	Uint8 r;
+	Uint8 g;
+	Uint8 b;
+	Uint8 a;
+};
+
+struct Vertex
+{
+	Vertex() {}
+	Vertex(const Vector2f& position, const Color& color) : position(position), color(color) {}
+
+	Vector2f position;
+	Color color;
+	Vector2f texCoords;
+};
+
+enum PrimitiveType
+{
+	Quads
+};
+
+class VertexArray
+{
+public:
+	explicit VertexArray(PrimitiveType = Quads, std::size_t vertexCount = 0) : vertices(vertexCount) {}
+
+	std::size_t getVertexCount() const { return vertices.size(); }
+	Vertex& operator[](std::size_t index) { return vertices[index]; }
+	const Vertex& operator[](std::size_t index) const { return vertices[index]; }
+	void clear() { vertices.clear(); }
+	void resize(std::size_t vertexCount) { vertices.resize(vertexCount); }
+	void append(const Vertex& vertex) { vertices.push_back(vertex); }
+
+private:
+	std::vector<Vertex> vertices;
+};
+
+class VertexBuffer
+{
+public:
+	enum Usage
+	{
+		Stream,
+		Dynamic,
+		Static
+	};
+
+	// offset and count of every update since the test last cleared the log
+	typedef std::pair<std::size_t, std::size_t> Upload;
+	static inline std::vector<Upload> uploads;
+	// what isAvailable reports, and whether every update fails as a lost context would
+	static inline bool available = true;
+	static inline bool failing = false;
+
+	VertexBuffer(PrimitiveType, Usage) : created(false) {}
+
+	static bool isAvailable() { return available; }
+
+	// the storage of a new buffer is undefined, here it holds vertices no frame draws
+	bool create(std::size_t vertexCount) {
+		if (!available) {
+			return false;
+		}
+		storage.assign(vertexCount, undefined());
+		created = true;
+		return true;
+	}
+
+	std::size_t getVertexCount() const { return storage.size(); }
+
+	bool update(const Vertex* vertices, std::size_t vertexCount, unsigned int offset) {
+		if (!created || !vertices || failing) {
+			return false;
+		}
+		if (offset && offset + vertexCount > storage.size()) {
+			return false;
+		}
+		// an update from the start as large as the buffer replaces the storage
+		if (vertexCount >= storage.size()) {
+			storage.assign(vertexCount, undefined());
+		}
+		for (std::size_t i = 0; i < vertexCount; i++) {
+			storage[offset + i] = vertices[i];
+		}
+		uploads.push_back(Upload(offset, vertexCount));
+		return true;
+	}
+
+	const Vertex* contents() const { return storage.data(); }
+
+private:
+	static Vertex undefined() { return Vertex(Vector2f(-1e9f, -1e9f), Color(1, 2, 3, 4)); }
+
+	std::vector<Vertex> storage;
+	bool created;
+};
+
+// remembers what the last draw call drew
+class RenderTarget
+{
+public:
+	RenderTarget() : buffer(nullptr), first(0), count(0), array(nullptr) {}
+
+	void draw(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount) {
+		buffer = &vertexBuffer;
+		first = firstVertex;
+		count = vertexCount;
+		array = nullptr;
+	}
+
+	void draw(const VertexArray& vertices) {
+		buffer = nullptr;
+		array = &vertices;
+	}
+
+	const VertexBuffer* buffer;
+	std::size_t first;
+	std::size_t count;
+	const VertexArray* array;
+};
+
+}
+
+#endif
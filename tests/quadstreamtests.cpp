@@ -0,0 +1,159 @@
+// quadstreamtests.cpp - the uploads QuadStream makes for typical and scattered changes, checked
+// against the SFML stand-in in tests/mock, and the buffer contents after every frame
+
+#include "tests.h"
+#include "../quadstream.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+typedef sf::VertexBuffer::Upload Upload;
+
+static void setQuad(sf::VertexArray& quads, size_t index, sf::Uint8 shade) {
+	const float x = (float)index;
+	const sf::Color colour(shade, 255 - shade, 0);
+	quads[4 * index] = sf::Vertex(sf::Vector2f(x, 0), colour);
+	quads[4 * index + 1] = sf::Vertex(sf::Vector2f(x + 1, 0), colour);
+	quads[4 * index + 2] = sf::Vertex(sf::Vector2f(x + 1, 10), colour);
+	quads[4 * index + 3] = sf::Vertex(sf::Vector2f(x, 10), colour);
+}
+
+static sf::VertexArray makeQuads(size_t count) {
+	sf::VertexArray quads(sf::Quads, 4 * count);
+	for (size_t i = 0; i < count; i++) {
+		setQuad(quads, i, 0);
+	}
+	return quads;
+}
+
+// draw a frame and check the buffer holds it, vertex for vertex
+static bool drawn(QuadStream& stream, sf::RenderTarget& target, const sf::VertexArray& quads) {
+	sf::VertexBuffer::uploads.clear();
+	stream.draw(target, quads);
+	const size_t count = quads.getVertexCount();
+	return target.buffer && target.first == 0 && target.count == count
+		&& std::memcmp(target.buffer->contents(), &quads[0], count * sizeof(sf::Vertex)) == 0;
+}
+
+static bool uploaded(const Upload& expected) {
+	return sf::VertexBuffer::uploads.size() == 1 && sf::VertexBuffer::uploads[0] == expected;
+}
+
+void quadStreamTests() {
+	std::cout << "quad stream: uploads" << std::endl;
+	sf::VertexBuffer::available = true;
+	sf::VertexBuffer::failing = false;
+	{
+		QuadStream stream;
+		sf::RenderTarget target;
+		sf::VertexArray quads = makeQuads(200);
+		CHECK(stream.streaming());
+
+		// the first frame fills the new buffer in one upload, an unchanged one sends nothing
+		CHECK(drawn(stream, target, quads));
+		CHECK(uploaded(Upload(0, 800)));
+		CHECK(drawn(stream, target, quads));
+		CHECK(sf::VertexBuffer::uploads.empty() && stream.uploaded() == 0);
+
+		// sixteen unchanged quads between two changes are sent along, seventeen split them
+		setQuad(quads, 10, 1);
+		setQuad(quads, 27, 1);
+		CHECK(drawn(stream, target, quads));
+		CHECK(uploaded(Upload(40, 72)));
+		setQuad(quads, 10, 2);
+		setQuad(quads, 28, 2);
+		CHECK(drawn(stream, target, quads));
+		CHECK(sf::VertexBuffer::uploads.size() == 2 && sf::VertexBuffer::uploads[0] == Upload(40, 4) && sf::VertexBuffer::uploads[1] == Upload(112, 4));
+
+		// eight separate runs go as eight uploads, a ninth turns them into one
+		// upload from the first change to the end
+		for (size_t i = 0; i < 8; i++) {
+			setQuad(quads, 5 + 20 * i, 3);
+		}
+		CHECK(drawn(stream, target, quads));
+		CHECK(sf::VertexBuffer::uploads.size() == 8);
+		CHECK(stream.uploaded() == 32);
+		for (size_t i = 0; i < 9; i++) {
+			setQuad(quads, 5 + 20 * i, 4);
+		}
+		CHECK(drawn(stream, target, quads));
+		CHECK(uploaded(Upload(20, 780)));
+
+		// more quads than the buffer holds recreate it at twice the size and refill it,
+		// fewer leave it alone
+		sf::VertexArray more = makeQuads(300);
+		CHECK(drawn(stream, target, more));
+		CHECK(uploaded(Upload(0, 1200)));
+		CHECK(target.buffer && target.buffer->getVertexCount() == 1600);
+		sf::VertexArray fewer = makeQuads(150);
+		CHECK(drawn(stream, target, fewer));
+		CHECK(sf::VertexBuffer::uploads.empty());
+
+		// growing again within the buffer sends only the quads past the known copy
+		sf::VertexArray grown = makeQuads(320);
+		CHECK(drawn(stream, target, grown));
+		CHECK(uploaded(Upload(1200, 80)));
+	}
+
+	std::cout << "quad stream: random frames" << std::endl;
+	{
+		QuadStream stream;
+		sf::RenderTarget target;
+		std::mt19937 random(25);
+		std::uniform_int_distribution<size_t> counts(50, 400);
+		std::uniform_int_distribution<int> changes(0, 30);
+		sf::VertexArray quads = makeQuads(counts(random));
+		unsigned int wrong = 0;
+		size_t mostUploads = 0;
+		for (unsigned int frame = 0; frame < 2000; frame++) {
+			// mostly a few bars moving, now and then a different bar count
+			if (frame % 97 == 0) {
+				const size_t count = counts(random);
+				sf::VertexArray resized = makeQuads(count);
+				for (size_t i = 0; i < 4 * count && i < quads.getVertexCount(); i++) {
+					resized[i] = quads[i];
+				}
+				quads = resized;
+			}
+			const size_t count = quads.getVertexCount() / 4;
+			const int changed = changes(random);
+			for (int c = 0; c < changed; c++) {
+				setQuad(quads, random() % count, (sf::Uint8)random());
+			}
+			if (!drawn(stream, target, quads)) {
+				wrong++;
+			}
+			mostUploads = std::max(mostUploads, sf::VertexBuffer::uploads.size());
+		}
+		CHECK(wrong == 0);
+		CHECK(mostUploads <= 8);
+	}
+
+	std::cout << "quad stream: fallback" << std::endl;
+	{
+		// without vertex buffers every frame is drawn from the array
+		sf::VertexBuffer::available = false;
+		QuadStream stream;
+		sf::RenderTarget target;
+		const sf::VertexArray quads = makeQuads(40);
+		stream.draw(target, quads);
+		CHECK(!stream.streaming() && target.array == &quads && !target.buffer);
+		sf::VertexBuffer::available = true;
+	}
+	{
+		// a failed upload gives up on the buffer for good, the frame is still drawn
+		QuadStream stream;
+		sf::RenderTarget target;
+		sf::VertexArray quads = makeQuads(40);
+		CHECK(drawn(stream, target, quads));
+		sf::VertexBuffer::failing = true;
+		setQuad(quads, 3, 9);
+		stream.draw(target, quads);
+		CHECK(!stream.streaming() && target.array == &quads);
+		sf::VertexBuffer::failing = false;
+		setQuad(quads, 4, 9);
+		stream.draw(target, quads);
+		CHECK(!stream.streaming() && target.array == &quads);
+	}
+}
@@ -0,0 +1,25 @@
+// tests.cpp - runs every test file and reports the failed checks,
+// the exit code is nonzero if any check failed
+
+#include "tests.h"
+#include <iostream>
+
+static unsigned int checks = 0;
+static unsigned int failures = 0;
+
+bool check(bool condition, const char* expression, const char* file, int line) {
+	checks++;
+	if (!condition) {
+		failures++;
+		std::cout << file << "(" << line << "): check failed: " << expression << std::endl;
+	}
+	return condition;
+}
+
+int main() {
+	analyserTests();
+	barStateTests();
+	quadStreamTests();
+	std::cout << checks << " checks, " << failures << " failed" << std::endl;
+	return failures ? 1 : 0;
+}
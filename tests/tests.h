@@ -0,0 +1,16 @@
+// tests.h - minimal checks shared by the test files, no framework needed
+
+#ifndef AUDIOANALYSER_TESTS_H
+#define AUDIOANALYSER_TESTS_H
+
+// records a failed condition with its place and returns whether it held
+bool check(bool condition, const char* expression, const char* file, int line);
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+// one entry point per test file, each runs all of its cases
+void analyserTests();
+void barStateTests();
+void quadStreamTests();
+
+#endif
@@ -0,0 +1,63 @@
+// triplebuffer.h - lock-free hand-over of whole frames from one producer thread to one consumer thread
+
+#ifndef AUDIOANALYSER_TRIPLEBUFFER_H
+#define AUDIOANALYSER_TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// three slots: the producer fills its back slot and swaps it with the middle one,
+// the consumer swaps its front slot with the middle one when that holds a newer frame,
+// neither side ever waits and the consumer always sees the newest complete frame
+template <class T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() : state(1), back(2), front(0), published(0), overwritten(0) {}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// producer side: the slot to fill, owned by the producer until publish()
+	T& write() {
+		return slots[back];
+	}
+
+	// producer side: hand the filled slot over, a frame still waiting
+	// in the middle slot is dropped and counted as overwritten
+	void publish() {
+		const unsigned previous = state.exchange(back | fresh, std::memory_order_acq_rel);
+		back = previous & index;
+		published.fetch_add(1, std::memory_order_relaxed);
+		if (previous & fresh) {
+			overwritten.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// consumer side: the newest complete frame, valid until the next call
+	const T& read() {
+		if (state.load(std::memory_order_relaxed) & fresh) {
+			front = state.exchange(front, std::memory_order_acq_rel) & index;
+		}
+		return slots[front];
+	}
+
+	// frames published so far and those replaced before the consumer read them,
+	// may be read from any thread
+	uint64_t publishedFrames() const { return published.load(std::memory_order_relaxed); }
+	uint64_t overwrittenFrames() const { return overwritten.load(std::memory_order_relaxed); }
+
+private:
+	// state holds the middle slot index and whether it was published since the last read
+	static const unsigned index = 3;
+	static const unsigned fresh = 4;
+
+	T slots[3];
+	std::atomic<unsigned> state;
+	unsigned back;
+	unsigned front;
+	std::atomic<uint64_t> published;
+	std::atomic<uint64_t> overwritten;
+};
+
+#endif
@@ -0,0 +1,114 @@
+// windowtable.cpp - window coefficients and table construction
+
+#include "windowtable.h"
+#include <cmath>
+
+// shape of the Kaiser window, side lobes near -70 dB
+static const double kaiserBeta = 8.0;
+
+const char* windowName(int type) {
+	switch (type) {
+	case rectangularWindow:
+		return "Rectangular";
+	case hannWindow:
+		return "Hann";
+	case hammingWindow:
+		return "Hamming";
+	case blackmanHarrisWindow:
+		return "Blackman-Harris";
+	case flatTopWindow:
+		return "Flat-Top";
+	case kaiserWindow:
+		return "Kaiser";
+	default:
+		return "Unknown";
+	}
+}
+
+// modified Bessel function of the first kind and order zero, by its power series
+static double besselI0(double x) {
+	double sum = 1, term = 1;
+	for (int k = 1; k < 50 && term > sum * 1e-12; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+bool WindowTable::build(int newType, size_t newLength) {
+	if (newType == type && newLength == length) {
+		return false;
+	}
+	type = newType;
+	length = newLength;
+	const bool resized = values.resize(length);
+
+	// a[m] of w[n] = sum of (-1)^m a[m] cos(2 pi m n / N)
+	double cosines[5] = { 1, 0, 0, 0, 0 };
+	count = 1;
+	switch (type) {
+	case hannWindow:
+		cosines[0] = 0.5;
+		cosines[1] = 0.5;
+		count = 2;
+		break;
+	case hammingWindow:
+		cosines[0] = 0.54;
+		cosines[1] = 0.46;
+		count = 2;
+		break;
+	case blackmanHarrisWindow:
+		cosines[0] = 0.35875;
+		cosines[1] = 0.48829;
+		cosines[2] = 0.14128;
+		cosines[3] = 0.01168;
+		count = 4;
+		break;
+	case flatTopWindow:
+		cosines[0] = 0.21557895;
+		cosines[1] = 0.41663158;
+		cosines[2] = 0.277263158;
+		cosines[3] = 0.083578947;
+		cosines[4] = 0.006947368;
+		count = 5;
+		break;
+	case kaiserWindow:
+		count = 0;
+		break;
+	default:
+		break;
+	}
+
+	const double pi = 3.14159265358979323846;
+	if (count > 0) {
+		// the mean of a cosine sum over whole periods is its constant term
+		for (size_t n = 0; n < length; n++) {
+			double value = cosines[0];
+			for (size_t m = 1; m < count; m++) {
+				value += (m & 1 ? -1 : 1) * cosines[m] * cos(2 * pi * m * n / length);
+			}
+			values[n] = (float)(value / cosines[0]);
+		}
+		// a cosine of m periods moves the spectrum by m bins either way, at half weight
+		coefficients[0] = 1;
+		for (size_t m = 1; m < count; m++) {
+			coefficients[m] = (m & 1 ? -0.5 : 0.5) * cosines[m] / cosines[0];
+		}
+	}
+	else {
+		// periodic Kaiser, the symmetric one of length N + 1 without its last point
+		double sum = 0;
+		const double scale = besselI0(kaiserBeta);
+		for (size_t n = 0; n < length; n++) {
+			const double ratio = 2.0 * n / length - 1;
+			const double value = besselI0(kaiserBeta * sqrt(1 - ratio * ratio)) / scale;
+			values[n] = (float)value;
+			sum += value;
+		}
+		const double mean = sum / length;
+		for (size_t n = 0; n < length; n++) {
+			values[n] = (float)(values[n] / mean);
+		}
+	}
+	return resized;
+}
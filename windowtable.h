@@ -0,0 +1,72 @@
+// windowtable.h - precomputed analysis window for one frame length
+
+#ifndef AUDIOANALYSER_WINDOWTABLE_H
+#define AUDIOANALYSER_WINDOWTABLE_H
+
+#include "buffer.h"
+#include "complex.h"
+#include <cstddef>
+
+enum WindowType
+{
+	rectangularWindow,
+	hannWindow,
+	hammingWindow,
+	blackmanHarrisWindow,
+	flatTopWindow,
+	kaiserWindow,
+	windowCount
+};
+
+const char* windowName(int type);
+
+// periodic window of the given length scaled to a mean of one, so a tone keeps its level
+// whichever window is picked; every type but Kaiser is a sum of cosines of whole periods
+// over the frame, which the spectrum of the unwindowed frame can be convolved with instead
+class WindowTable
+{
+public:
+	WindowTable() : type(-1), length(0), count(0) {}
+
+	WindowTable(const WindowTable&) = delete;
+	WindowTable& operator=(const WindowTable&) = delete;
+
+	// recompute for the given type and length, nothing happens while both stay the same,
+	// returns true if storage had to be allocated
+	bool build(int type, size_t length);
+
+	const float* data() const { return values.data(); }
+
+	// whether the window is a sum of cosines, and how many, the constant term included
+	bool cosineSum() const { return count > 0; }
+	size_t terms() const { return count; }
+
+	// windowed bins [0, bins) from bins [0, bins + terms - 1) of the unwindowed spectrum
+	// of a real frame, no further than length / 2: X'[k] = sum of c[m] (X[k - m] + X[k + m]),
+	// with X[-j] = X[N - j] = conj(X[j])
+	template <class T>
+	void convolve(const tcomplex<T>* spectrum, tcomplex<T>* result, size_t bins) const;
+
+private:
+	int type;
+	size_t length;
+	size_t count;
+	// halved cosine coefficients with alternating signs, scaled with the table
+	double coefficients[5];
+	AlignedBuffer<float> values;
+};
+
+template <class T>
+void WindowTable::convolve(const tcomplex<T>* const spectrum, tcomplex<T>* const result, size_t bins) const {
+	for (size_t k = 0; k < bins; k++) {
+		tcomplex<T> sum = spectrum[k] * T(coefficients[0]);
+		for (size_t m = 1; m < count; m++) {
+			const tcomplex<T> below = k >= m ? spectrum[k - m] : spectrum[m - k].conjugate();
+			const tcomplex<T> above = k + m <= length / 2 ? spectrum[k + m] : spectrum[length - k - m].conjugate();
+			sum += (below + above) * T(coefficients[m]);
+		}
+		result[k] = sum;
+	}
+}
+
+#endif